@@ -0,0 +1,158 @@
+// MIT License
+//
+// Copyright (c) 2026 Levin Tertilt
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Counts the allocations of a single getShaderSource call on warm caches and fails if any case exceeds its budget.
+// The budgets are the counts measured with GCC 12.2 and its libstdc++ (listed next to every case) plus about 10%, so
+// that differing growth strategies of other standard library versions do not fail the check. Other toolchains may
+// need their own baselines. If a change reduces the counts, the budgets should be lowered accordingly, so that later
+// regressions are caught
+
+#include "alloc_tracking.h"
+#include "corpus.h"
+
+#include <algorithm>
+#include <format>
+#include <functional>
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+#include <glsl/glsl_source_processor.h>
+
+struct AllocationCase {
+    const char* name;
+    std::uint64_t allocationBudget;
+    std::uint64_t byteBudget;
+    // Prepares the corpus and returns the measured call
+    std::function<std::function<bool()>(const TemporaryCorpus&)> setup;
+};
+
+template<typename PROVIDER>
+static GLSLSourceProcessor<FileSourceProvider<PROVIDER>> makeProcessor(const TemporaryCorpus& corpus,
+    std::size_t definitions = 4) {
+    GLSLSourceProcessor processor(FileSourceProvider(PROVIDER{}, SplitDirectories(corpus.getRoot())));
+    for (std::size_t i = 0; i < definitions; ++i) {
+        processor.define(std::format("DEFINITION_{}", i), i);
+    }
+    return processor;
+}
+
+// Returns a call processing the shader with the processor
+template<typename PROCESSOR>
+static std::function<bool()> processShader(PROCESSOR processor, std::string shader) {
+    return [processor = std::move(processor), shader = std::move(shader)] {
+        return processor.getShaderSource(shader).has_value();
+    };
+}
+
+static std::string generateIncludes(std::size_t first, std::size_t count) {
+    std::string includes;
+    for (std::size_t i = first; i < first + count; ++i) {
+        includes += std::format("#include \"include_{}.glsl\"\n", i);
+    }
+    return includes;
+}
+
+static const AllocationCase CASES[] = {
+    // Measured: 8 allocations, 9136 bytes
+    {"noIncludes", 9, 10000, [](const TemporaryCorpus& corpus) {
+        corpus.addSource("shader.glsl", generateShaderCode(4096));
+        return processShader(makeProcessor<CachedFileProvider>(corpus), "shader.glsl");
+    }},
+    // Measured: 132 allocations, 83260 bytes
+    {"flatIncludes", 145, 91500, [](const TemporaryCorpus& corpus) {
+        corpus.addSource("shader.glsl", generateIncludes(0, 16) + generateShaderCode(1024));
+        for (std::size_t i = 0; i < 16; ++i) {
+            corpus.addInclude(std::format("include_{}.glsl", i), generateShaderCode(1024, i));
+        }
+        return processShader(makeProcessor<CachedFileProvider>(corpus), "shader.glsl");
+    }},
+    // Measured: 75 allocations, 26061 bytes
+    {"nestedIncludes", 83, 28500, [](const TemporaryCorpus& corpus) {
+        // A chain where every header also includes all headers after it, so most includes are skipped
+        corpus.addSource("shader.glsl", generateIncludes(0, 8) + generateShaderCode(1024));
+        for (std::size_t i = 0; i < 8; ++i) {
+            corpus.addInclude(std::format("include_{}.glsl", i), generateIncludes(i + 1, 7 - i) +
+                generateShaderCode(512, i));
+        }
+        return processShader(makeProcessor<CachedFileProvider>(corpus), "shader.glsl");
+    }},
+    // Measured: 137 allocations, 84337 bytes
+    {"includedFiles", 151, 92500, [](const TemporaryCorpus& corpus) {
+        corpus.addSource("shader.glsl", generateIncludes(0, 16) + generateShaderCode(1024));
+        for (std::size_t i = 0; i < 16; ++i) {
+            corpus.addInclude(std::format("include_{}.glsl", i), generateShaderCode(1024, i));
+        }
+        return [processor = makeProcessor<CachedFileProvider>(corpus)] {
+            std::vector<std::string> includedFiles;
+            return processor.getShaderSource("shader.glsl", includedFiles).has_value();
+        };
+    }},
+    // Measured: 132 allocations, 83600 bytes
+    {"smartCachedBatch", 145, 92000, [](const TemporaryCorpus& corpus) {
+        corpus.addSource("shader.glsl", generateIncludes(0, 16) + generateShaderCode(1024));
+        for (std::size_t i = 0; i < 16; ++i) {
+            corpus.addInclude(std::format("include_{}.glsl", i), generateShaderCode(1024, i));
+        }
+        auto processor = makeProcessor<SmartCachedFileProvider>(corpus);
+        processor.getSourceProvider().getImpl().beginBatch();
+        return processShader(std::move(processor), "shader.glsl");
+    }},
+};
+
+int main(int argc, char** argv) {
+    std::vector<std::string_view> filters(argv + 1, argv + argc);
+
+    bool exceeded = false;
+    std::cout << std::format("{:<24} {:>12} {:>12} {:>12} {:>12}\n", "case", "allocations", "budget", "bytes",
+        "budget");
+    for (const AllocationCase& allocationCase : CASES) {
+        std::string_view name = allocationCase.name;
+        if (!filters.empty() && std::ranges::none_of(filters, [&](std::string_view filter) {
+            return name.find(filter) != std::string_view::npos;
+        })) {
+            continue;
+        }
+
+        TemporaryCorpus corpus(name);
+        std::function<bool()> call = allocationCase.setup(corpus);
+
+        // Fills the caches, so only the steady state is measured
+        if (!call()) {
+            std::cout << std::format("{:<24} failed to process\n", name);
+            exceeded = true;
+            continue;
+        }
+
+        AllocationScope scope;
+        bool success = call();
+        AllocationCounts counts = scope.get();
+
+        bool withinBudget = success && counts.allocations <= allocationCase.allocationBudget &&
+            counts.bytes <= allocationCase.byteBudget;
+        exceeded |= !withinBudget;
+        std::cout << std::format("{:<24} {:>12} {:>12} {:>12} {:>12}{}\n", name, counts.allocations,
+            allocationCase.allocationBudget, counts.bytes, allocationCase.byteBudget,
+            withinBudget ? "" : "  EXCEEDED");
+    }
+    return exceeded ? 1 : 0;
+}
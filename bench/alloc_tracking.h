@@ -0,0 +1,52 @@
+// MIT License
+//
+// Copyright (c) 2026 Levin Tertilt
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+
+/// Allocations made through the global operator new. Only available in executables linking alloc_tracking.cpp, which
+/// replaces the global allocation functions
+struct AllocationCounts {
+    std::uint64_t allocations = 0;
+    std::uint64_t deallocations = 0;
+    std::uint64_t bytes = 0;
+
+    AllocationCounts operator-(const AllocationCounts& other) const {
+        return {allocations - other.allocations, deallocations - other.deallocations, bytes - other.bytes};
+    }
+};
+
+/// Returns the allocations of the calling thread since it started
+AllocationCounts getThreadAllocations();
+
+/// Counts the allocations of the calling thread during its lifetime
+class AllocationScope {
+public:
+    AllocationScope() :
+        start_(getThreadAllocations()) {}
+
+    [[nodiscard]] AllocationCounts get() const { return getThreadAllocations() - start_; }
+
+private:
+    AllocationCounts start_;
+};
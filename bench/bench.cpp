@@ -0,0 +1,331 @@
+// MIT License
+//
+// Copyright (c) 2026 Levin Tertilt
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "bench.h"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#ifdef __unix__
+#include <unistd.h>
+#endif
+
+struct RegisteredBenchmark {
+    std::string name;
+    BenchmarkFunction function;
+};
+
+static std::vector<RegisteredBenchmark>& getBenchmarks() {
+    static std::vector<RegisteredBenchmark> benchmarks;
+    return benchmarks;
+}
+
+bool registerBenchmark(std::string name, BenchmarkFunction function) {
+    getBenchmarks().push_back({std::move(name), std::move(function)});
+    return true;
+}
+
+// Runs the benchmark with a growing amount of iterations until a single run takes at least minTime
+static BenchmarkState runBenchmark(const RegisteredBenchmark& benchmark, std::chrono::nanoseconds minTime,
+    PerfCounters* perfCounters) {
+    constexpr std::uint64_t MAX_ITERATIONS = 1'000'000'000;
+
+    std::uint64_t iterations = 1;
+    while (true) {
+        BenchmarkState state(iterations, perfCounters);
+        benchmark.function(state);
+
+        std::chrono::nanoseconds elapsed = state.getElapsed();
+        if (elapsed >= minTime || iterations >= MAX_ITERATIONS) {
+            return state;
+        }
+
+        double scale = elapsed.count() > 0 ? 1.4 * static_cast<double>(minTime.count()) /
+            static_cast<double>(elapsed.count()) : 10.0;
+        iterations = std::min(MAX_ITERATIONS, static_cast<std::uint64_t>(static_cast<double>(iterations) *
+            std::clamp(scale, 2.0, 10.0)));
+    }
+}
+
+// The repetitions of a benchmark, all with the same amount of iterations
+struct BenchmarkResult {
+    std::string_view name;
+    std::vector<double> nsPerIteration;
+    // The custom counters and hardware events are taken from the last repetition
+    BenchmarkState last;
+};
+
+static double getNsPerIteration(const BenchmarkState& state) {
+    return static_cast<double>(state.getElapsed().count()) / static_cast<double>(state.getIterations());
+}
+
+static double getMedian(std::vector<double> values) {
+    std::ranges::sort(values);
+    std::size_t middle = values.size() / 2;
+    return values.size() % 2 == 1 ? values[middle] : (values[middle - 1] + values[middle]) / 2.0;
+}
+
+// The median absolute deviation, a measure of the noise that is robust against outliers
+static double getMedianAbsoluteDeviation(const std::vector<double>& values) {
+    double median = getMedian(values);
+    std::vector<double> deviations;
+    for (double value : values) {
+        deviations.push_back(std::abs(value - median));
+    }
+    return getMedian(std::move(deviations));
+}
+
+static BenchmarkResult runRepetitions(const RegisteredBenchmark& benchmark, std::chrono::nanoseconds minTime,
+    unsigned repetitions, PerfCounters* perfCounters) {
+    BenchmarkResult result{benchmark.name, {}, runBenchmark(benchmark, minTime, perfCounters)};
+    result.nsPerIteration.push_back(getNsPerIteration(result.last));
+    for (unsigned i = 1; i < repetitions; ++i) {
+        BenchmarkState state(result.last.getIterations(), perfCounters);
+        benchmark.function(state);
+        result.nsPerIteration.push_back(getNsPerIteration(state));
+        result.last = std::move(state);
+    }
+    return result;
+}
+
+static void printResult(const BenchmarkResult& result) {
+    const BenchmarkState& state = result.last;
+    double nsPerIteration = getMedian(result.nsPerIteration);
+
+    std::string line = std::format("{:<40} {:>12} iterations {:>14.1f} ns/op", result.name, state.getIterations(),
+        nsPerIteration);
+    if (result.nsPerIteration.size() > 1) {
+        line += std::format(" (MAD {:.1f})", getMedianAbsoluteDeviation(result.nsPerIteration));
+    }
+    if (state.getBytesPerIteration() > 0) {
+        double bytesPerSecond = static_cast<double>(state.getBytesPerIteration()) * 1e9 / nsPerIteration;
+        line += std::format(" {:>10.1f} MiB/s", bytesPerSecond / (1024.0 * 1024.0));
+    }
+    for (const auto& [counter, value] : state.getCounters()) {
+        line += std::format(" {}={:.3f}", counter, value);
+    }
+
+    const PerfCounts& perfCounts = state.getPerfCounts();
+    auto iterations = static_cast<double>(state.getIterations());
+    for (std::size_t i = 0; i < PERF_EVENT_COUNT; ++i) {
+        if (perfCounts[i].has_value()) {
+            line += std::format(" {}/op={:.1f}", PERF_EVENT_NAMES[i], *perfCounts[i] / iterations);
+        }
+    }
+    auto cycles = perfCounts[static_cast<std::size_t>(PerfEvent::Cycles)];
+    auto instructions = perfCounts[static_cast<std::size_t>(PerfEvent::Instructions)];
+    if (cycles.has_value() && instructions.has_value() && *cycles > 0) {
+        line += std::format(" IPC={:.2f}", *instructions / *cycles);
+    }
+    std::cout << line << std::endl;
+}
+
+static std::string escapeJSON(std::string_view text) {
+    std::string escaped = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+            escaped += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            escaped += std::format("\\u{:04x}", c);
+        } else {
+            escaped += c;
+        }
+    }
+    escaped += '"';
+    return escaped;
+}
+
+static std::string getCompiler() {
+#if defined(__clang__)
+    return std::format("Clang {}.{}.{}", __clang_major__, __clang_minor__, __clang_patchlevel__);
+#elif defined(__GNUC__)
+    return std::format("GCC {}.{}.{}", __GNUC__, __GNUC_MINOR__, __GNUC_PATCHLEVEL__);
+#elif defined(_MSC_VER)
+    return std::format("MSVC {}", _MSC_FULL_VER);
+#else
+    return "unknown";
+#endif
+}
+
+static std::string getCpuName() {
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(cpuinfo, line)) {
+        if (line.starts_with("model name")) {
+            std::size_t separator = line.find(':');
+            return separator == std::string::npos ? line : line.substr(line.find_first_not_of(' ', separator + 1));
+        }
+    }
+    return "unknown";
+}
+
+static std::string getHostName() {
+#ifdef __unix__
+    char name[256] = {};
+    if (gethostname(name, sizeof(name) - 1) == 0) {
+        return name;
+    }
+#endif
+    return "unknown";
+}
+
+// JSON has no representation for infinity and NaN, e.g. of a counter divided by zero, so they are written as null
+static std::string formatJSONNumber(double value) {
+    return std::isfinite(value) ? std::format("{}", value) : "null";
+}
+
+// Writes the results together with a description of the machine and the build, as read by glsl_sp_bench_compare
+static void writeJSON(std::ostream& stream, const std::vector<BenchmarkResult>& results, double minTimeSeconds) {
+    std::time_t now = std::time(nullptr);
+    char date[32] = {};
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+    stream << "{\n  \"context\": {\n"
+           << "    \"date\": " << escapeJSON(date) << ",\n"
+           << "    \"host\": " << escapeJSON(getHostName()) << ",\n"
+           << "    \"cpu\": " << escapeJSON(getCpuName()) << ",\n"
+           << "    \"hardware_threads\": " << std::thread::hardware_concurrency() << ",\n"
+           << "    \"compiler\": " << escapeJSON(getCompiler()) << ",\n"
+#ifdef NDEBUG
+           << "    \"assertions\": false,\n"
+#else
+           << "    \"assertions\": true,\n"
+#endif
+           << "    \"min_time\": " << std::format("{}", minTimeSeconds) << "\n  },\n  \"benchmarks\": [";
+
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const BenchmarkResult& result = results[i];
+        stream << (i == 0 ? "\n" : ",\n") << "    {\"name\": " << escapeJSON(result.name)
+               << ", \"iterations\": " << result.last.getIterations()
+               << ", \"bytes_per_iteration\": " << result.last.getBytesPerIteration()
+               << ", \"median_ns\": " << formatJSONNumber(getMedian(result.nsPerIteration))
+               << ", \"mad_ns\": " << formatJSONNumber(getMedianAbsoluteDeviation(result.nsPerIteration))
+               << ", \"ns_per_iteration\": [";
+        for (std::size_t j = 0; j < result.nsPerIteration.size(); ++j) {
+            stream << (j == 0 ? "" : ", ") << formatJSONNumber(result.nsPerIteration[j]);
+        }
+        stream << "], \"counters\": {";
+        bool first = true;
+        for (const auto& [counter, value] : result.last.getCounters()) {
+            stream << (first ? "" : ", ") << escapeJSON(counter) << ": " << formatJSONNumber(value);
+            first = false;
+        }
+        // The hardware events per iteration, only present if they were counted
+        stream << "}, \"perf\": {";
+        first = true;
+        auto iterations = static_cast<double>(result.last.getIterations());
+        for (std::size_t j = 0; j < PERF_EVENT_COUNT; ++j) {
+            if (const std::optional<double>& count = result.last.getPerfCounts()[j]) {
+                stream << (first ? "" : ", ") << escapeJSON(PERF_EVENT_NAMES[j]) << ": "
+                       << formatJSONNumber(*count / iterations);
+                first = false;
+            }
+        }
+        stream << "}}";
+    }
+    stream << "\n  ]\n}\n";
+}
+
+static void printUsage() {
+    std::cout << "Usage: glsl_sp_bench [options] [filter...]\n"
+                 "Runs all benchmarks whose name contains one of the filters, or all if none are given\n"
+                 "  --min-time <seconds>     Minimum duration of a repetition (default: 0.5)\n"
+                 "  --repetitions <count>    Runs every benchmark repeatedly and reports the median (default: 1)\n"
+                 "  --json <file>            Writes the results and a description of the machine as JSON\n"
+                 "  --perf                   Reports the cycles, instructions, cache misses and branch misses in\n"
+                 "                           user space as well, including threads started by the benchmarks\n";
+}
+
+int main(int argc, char** argv) {
+    double minTimeSeconds = 0.5;
+    unsigned repetitions = 1;
+    std::string jsonPath;
+    bool perf = false;
+    std::vector<std::string_view> filters;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        if (arg == "--min-time" && i + 1 < argc) {
+            std::string_view value = argv[++i];
+            if (std::from_chars(value.data(), value.data() + value.size(), minTimeSeconds).ec != std::errc{}) {
+                printUsage();
+                return 1;
+            }
+        } else if (arg == "--repetitions" && i + 1 < argc) {
+            std::string_view value = argv[++i];
+            if (std::from_chars(value.data(), value.data() + value.size(), repetitions).ec != std::errc{} ||
+                repetitions == 0) {
+                printUsage();
+                return 1;
+            }
+        } else if (arg == "--json" && i + 1 < argc) {
+            jsonPath = argv[++i];
+        } else if (arg == "--perf") {
+            perf = true;
+        } else if (arg == "--help" || arg.starts_with("--")) {
+            printUsage();
+            return arg == "--help" ? 0 : 1;
+        } else {
+            filters.push_back(arg);
+        }
+    }
+
+    std::optional<PerfCounters> perfCounters;
+    if (perf) {
+        std::string error;
+        perfCounters = PerfCounters::open(&error);
+        if (!perfCounters.has_value()) {
+            std::cerr << "Hardware counters are not available: " << error << std::endl;
+        }
+    }
+
+    auto minTime = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::duration<double>(minTimeSeconds));
+    std::vector<BenchmarkResult> results;
+    for (const RegisteredBenchmark& benchmark : getBenchmarks()) {
+        std::string_view name = benchmark.name;
+        if (!filters.empty() && std::ranges::none_of(filters, [&](std::string_view filter) {
+            return name.find(filter) != std::string_view::npos;
+        })) {
+            continue;
+        }
+        results.push_back(runRepetitions(benchmark, minTime, repetitions, perfCounters ? &*perfCounters : nullptr));
+        printResult(results.back());
+    }
+
+    if (!jsonPath.empty()) {
+        std::ofstream file(jsonPath, std::ios::binary | std::ios::trunc);
+        writeJSON(file, results, minTimeSeconds);
+        if (!file) {
+            std::cerr << "Failed to write: " << jsonPath << std::endl;
+            return 1;
+        }
+    }
+}
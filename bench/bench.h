@@ -0,0 +1,107 @@
+// MIT License
+//
+// Copyright (c) 2026 Levin Tertilt
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+
+#include "perf_counters.h"
+
+/// Passed to every benchmark. The measured code runs once per iteration, anything before the loop is not timed:
+///
+///     while (state.keepRunning()) { ... }
+class BenchmarkState {
+public:
+    /// If perf counters are given, the hardware events of the timed loop are counted as well
+    explicit BenchmarkState(std::uint64_t iterations, PerfCounters* perfCounters = nullptr) :
+        iterations_(iterations),
+        remaining_(iterations),
+        perfCounters_(perfCounters) {}
+
+    bool keepRunning() {
+        if (remaining_ == iterations_) {
+            if (perfCounters_ != nullptr) {
+                perfCounters_->start();
+            }
+            start_ = std::chrono::steady_clock::now();
+        }
+        if (remaining_ == 0) {
+            end_ = std::chrono::steady_clock::now();
+            if (perfCounters_ != nullptr) {
+                perfCounters_->stop();
+                perfCounts_ = perfCounters_->read();
+            }
+            return false;
+        }
+        --remaining_;
+        return true;
+    }
+
+    /// The amount of bytes processed by one iteration, used to report the throughput
+    void setBytesPerIteration(std::uint64_t bytes) { bytesPerIteration_ = bytes; }
+
+    /// Adds a custom value to the report of this benchmark
+    void setCounter(const std::string& name, double value) { counters_.insert_or_assign(name, value); }
+
+    [[nodiscard]] std::uint64_t getIterations() const { return iterations_; }
+    [[nodiscard]] std::uint64_t getBytesPerIteration() const { return bytesPerIteration_; }
+    [[nodiscard]] const std::map<std::string, double>& getCounters() const { return counters_; }
+    [[nodiscard]] std::chrono::nanoseconds getElapsed() const { return end_ - start_; }
+    /// The hardware events of all iterations, empty if they were not counted
+    [[nodiscard]] const PerfCounts& getPerfCounts() const { return perfCounts_; }
+
+private:
+    std::uint64_t iterations_;
+    std::uint64_t remaining_;
+    std::uint64_t bytesPerIteration_ = 0;
+    std::map<std::string, double> counters_;
+    PerfCounters* perfCounters_;
+    PerfCounts perfCounts_;
+    std::chrono::steady_clock::time_point start_;
+    std::chrono::steady_clock::time_point end_;
+};
+
+using BenchmarkFunction = std::function<void(BenchmarkState&)>;
+
+/// Registers a benchmark, benchmarks with parameters only known at runtime may be registered by static initializers
+bool registerBenchmark(std::string name, BenchmarkFunction function);
+
+/// Defines and registers a benchmark, which can then be selected by its name on the command line
+#define GLSL_BENCHMARK(NAME) \
+    static void NAME(BenchmarkState& state); \
+    [[maybe_unused]] static const bool NAME##Registered = registerBenchmark(#NAME, NAME); \
+    static void NAME(BenchmarkState& state)
+
+/// Prevents the compiler from optimizing away the computation of a value
+template<typename T>
+void doNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
@@ -0,0 +1,90 @@
+// MIT License
+//
+// Copyright (c) 2026 Levin Tertilt
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "bench.h"
+#include "corpus.h"
+
+#include <vector>
+
+#include <glsl/glsl_compressed_file_provider.h>
+#include <glsl/glsl_source_processor.h>
+
+// Measures the compression ratio of CompressedCachedFileProvider on generated shader code, and the latency of an
+// access to a cached file for the different kinds of cache entries
+
+constexpr std::size_t FILE_COUNT = 256;
+constexpr std::size_t FILE_SIZE = 8 * 1024;
+
+struct CompressionFixture {
+    TemporaryCorpus corpus;
+    std::vector<std::filesystem::path> files;
+
+    CompressionFixture() :
+        corpus("compression") {
+        for (std::size_t i = 0; i < FILE_COUNT; ++i) {
+            std::string filename = std::format("file_{}.glsl", i);
+            corpus.addInclude(filename, generateShaderCode(FILE_SIZE, static_cast<std::uint32_t>(i)));
+            files.push_back(corpus.getRoot() / "include" / filename);
+        }
+    }
+};
+
+static const CompressionFixture& getFixture() {
+    static const CompressionFixture fixture;
+    return fixture;
+}
+
+template<FileProviderImpl IMPL>
+static void accessAll(BenchmarkState& state, const IMPL& impl) {
+    const CompressionFixture& fixture = getFixture();
+
+    std::uint64_t totalSize = 0;
+    for (const std::filesystem::path& file : fixture.files) {
+        totalSize += impl.getString(file)->size();
+    }
+    state.setBytesPerIteration(totalSize);
+
+    while (state.keepRunning()) {
+        for (const std::filesystem::path& file : fixture.files) {
+            doNotOptimize(impl.getString(file));
+        }
+    }
+    state.setCounter("ns_per_file", static_cast<double>(state.getElapsed().count()) /
+        static_cast<double>(state.getIterations() * fixture.files.size()));
+}
+
+GLSL_BENCHMARK(accessUncompressedCache) {
+    accessAll(state, CachedFileProvider{});
+}
+
+// Every file stays in the hot set
+GLSL_BENCHMARK(accessCompressedCacheHot) {
+    accessAll(state, CompressedCachedFileProvider(FILE_COUNT));
+}
+
+// Every access has to decompress the file
+GLSL_BENCHMARK(accessCompressedCacheCold) {
+    CompressedCachedFileProvider impl(0);
+    accessAll(state, impl);
+    state.setCounter("ratio", static_cast<double>(impl.getUncompressedSize()) /
+        static_cast<double>(impl.getCompressedSize()));
+}
@@ -0,0 +1,127 @@
+// MIT License
+//
+// Copyright (c) 2026 Levin Tertilt
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "bench.h"
+
+#include <algorithm>
+#include <format>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <glsl/glsl_flat_map.h>
+
+// Compares FlatHashMap to std::unordered_map as used by the caches and the processor: keys are include paths, looked
+// up in a different order than they were inserted, so the lookups do not walk the allocations of std::unordered_map
+// in order and the hardware prefetcher can not hide their cost. Every benchmark reports the time of a single operation
+// in ns_per_op
+
+constexpr std::size_t MIN_ENTRIES = 100;
+constexpr std::size_t MAX_ENTRIES = 100'000;
+
+struct MapFixture {
+    // The keys in the order of their insertion
+    std::vector<std::string> keys;
+    // The same keys in a random order, and keys of the same shape that are not part of the map
+    std::vector<std::string> lookupKeys;
+    std::vector<std::string> missingKeys;
+
+    explicit MapFixture(std::size_t count) {
+        for (std::size_t i = 0; i < count; ++i) {
+            keys.push_back(std::format("shaders/include/module_{}/header_{}.glsl", i % 61, i));
+            missingKeys.push_back(std::format("shaders/include/module_{}/missing_{}.glsl", i % 61, i));
+        }
+        lookupKeys = keys;
+        std::mt19937 random(static_cast<std::uint32_t>(count));
+        std::ranges::shuffle(lookupKeys, random);
+        std::ranges::shuffle(missingKeys, random);
+    }
+};
+
+template<typename MAP>
+static MAP makeMap(const MapFixture& fixture) {
+    MAP map;
+    for (std::size_t i = 0; i < fixture.keys.size(); ++i) {
+        map.try_emplace(fixture.keys[i], i);
+    }
+    return map;
+}
+
+static void reportPerOperation(BenchmarkState& state, std::size_t operations) {
+    state.setCounter("ns_per_op", static_cast<double>(state.getElapsed().count()) /
+        static_cast<double>(state.getIterations() * operations));
+}
+
+template<typename MAP>
+static void lookup(BenchmarkState& state, const MapFixture& fixture, const std::vector<std::string>& keys) {
+    const MAP map = makeMap<MAP>(fixture);
+    while (state.keepRunning()) {
+        std::size_t found = 0;
+        for (const std::string& key : keys) {
+            found += map.find(key) != map.end() ? 1 : 0;
+        }
+        doNotOptimize(found);
+    }
+    reportPerOperation(state, keys.size());
+}
+
+// Builds the map from scratch, including the copies of the keys
+template<typename MAP>
+static void insert(BenchmarkState& state, const MapFixture& fixture) {
+    while (state.keepRunning()) {
+        MAP map = makeMap<MAP>(fixture);
+        doNotOptimize(map);
+    }
+    reportPerOperation(state, fixture.keys.size());
+}
+
+template<typename MAP>
+static void registerMapBenchmarks(const std::string& name) {
+    for (std::size_t count = MIN_ENTRIES; count <= MAX_ENTRIES; count *= 10) {
+        // Shared by the benchmarks of one size, created by the first one that runs
+        auto fixture = std::make_shared<std::unique_ptr<MapFixture>>();
+        auto getFixture = [fixture, count]() -> const MapFixture& {
+            if (*fixture == nullptr) {
+                *fixture = std::make_unique<MapFixture>(count);
+            }
+            return **fixture;
+        };
+
+        registerBenchmark(std::format("{}LookupHit/{}", name, count), [getFixture](BenchmarkState& state) {
+            lookup<MAP>(state, getFixture(), getFixture().lookupKeys);
+        });
+        registerBenchmark(std::format("{}LookupMiss/{}", name, count), [getFixture](BenchmarkState& state) {
+            lookup<MAP>(state, getFixture(), getFixture().missingKeys);
+        });
+        registerBenchmark(std::format("{}Insert/{}", name, count), [getFixture](BenchmarkState& state) {
+            insert<MAP>(state, getFixture());
+        });
+    }
+}
+
+[[maybe_unused]] static const bool mapsRegistered = [] {
+    registerMapBenchmarks<StringMap<std::size_t>>("flatMap");
+    registerMapBenchmarks<std::unordered_map<std::string, std::size_t>>("unorderedMap");
+    return true;
+}();
@@ -0,0 +1,90 @@
+// MIT License
+//
+// Copyright (c) 2026 Levin Tertilt
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "bench.h"
+#include "corpus.h"
+
+#include <vector>
+
+#include <glsl/glsl_source_processor.h>
+
+// Compares the iostream based reader with the POSIX one, on a typical tree of small shader files as well as on a
+// single large file
+
+constexpr std::size_t SMALL_FILE_COUNT = 512;
+constexpr std::size_t SMALL_FILE_SIZE = 2 * 1024;
+constexpr std::size_t LARGE_FILE_SIZE = 16 * 1024 * 1024;
+
+struct IOFixture {
+    TemporaryCorpus corpus;
+    std::vector<std::filesystem::path> files;
+    std::uint64_t totalSize = 0;
+
+    IOFixture(std::string_view name, std::size_t fileCount, std::size_t fileSize) :
+        corpus(name) {
+        for (std::size_t i = 0; i < fileCount; ++i) {
+            std::string code = generateShaderCode(fileSize, static_cast<std::uint32_t>(i));
+            std::string filename = std::format("file_{}.glsl", i);
+            corpus.addInclude(filename, code);
+            files.push_back(corpus.getRoot() / "include" / filename);
+            totalSize += code.size();
+        }
+    }
+};
+
+static const IOFixture& getSmallFiles() {
+    static const IOFixture fixture("io_small", SMALL_FILE_COUNT, SMALL_FILE_SIZE);
+    return fixture;
+}
+
+static const IOFixture& getLargeFile() {
+    static const IOFixture fixture("io_large", 1, LARGE_FILE_SIZE);
+    return fixture;
+}
+
+template<auto READ>
+static void readAll(BenchmarkState& state, const IOFixture& fixture) {
+    state.setBytesPerIteration(fixture.totalSize);
+    while (state.keepRunning()) {
+        for (const std::filesystem::path& file : fixture.files) {
+            doNotOptimize(READ(file));
+        }
+    }
+}
+
+GLSL_BENCHMARK(readSmallFilesStream) {
+    readAll<readStringStream>(state, getSmallFiles());
+}
+
+GLSL_BENCHMARK(readLargeFileStream) {
+    readAll<readStringStream>(state, getLargeFile());
+}
+
+#if GLSL_SP_POSIX_IO
+GLSL_BENCHMARK(readSmallFilesPosix) {
+    readAll<readStringPosix>(state, getSmallFiles());
+}
+
+GLSL_BENCHMARK(readLargeFilePosix) {
+    readAll<readStringPosix>(state, getLargeFile());
+}
+#endif
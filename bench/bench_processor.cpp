@@ -0,0 +1,117 @@
+// MIT License
+//
+// Copyright (c) 2026 Levin Tertilt
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "bench.h"
+#include "corpus.h"
+
+#include <memory>
+
+#include <glsl/glsl_source_processor.h>
+
+// Measures the throughput of GLSLSourceProcessor on warm caches, so that only the expansion of the sources is timed.
+// The wide shader is read without a cache instead, to compare reading the includes on the calling thread to reading
+// them ahead on a thread pool
+
+constexpr std::size_t HEADER_COUNT = 32;
+constexpr std::size_t HEADER_SIZE = 2 * 1024;
+// The wide shader includes independent subtrees, each a module that includes its own headers and a shared one
+constexpr std::size_t MODULE_COUNT = 64;
+constexpr std::size_t HEADERS_PER_MODULE = 4;
+
+struct ProcessorFixture {
+    TemporaryCorpus corpus;
+
+    ProcessorFixture() :
+        corpus("processor") {
+        corpus.addSource("leaf.glsl", generateShaderCode(64 * 1024));
+
+        std::string includes;
+        for (std::size_t i = 0; i < HEADER_COUNT; ++i) {
+            includes += std::format("#include \"header_{}.glsl\"\n", i);
+            corpus.addInclude(std::format("header_{}.glsl", i),
+                generateShaderCode(HEADER_SIZE, static_cast<std::uint32_t>(i)));
+        }
+        corpus.addSource("includes.glsl", includes + generateShaderCode(HEADER_SIZE));
+
+        std::string modules;
+        corpus.addInclude("shared.glsl", generateShaderCode(HEADER_SIZE));
+        for (std::size_t i = 0; i < MODULE_COUNT; ++i) {
+            modules += std::format("#include \"module_{}/module.glsl\"\n", i);
+            std::string module = "#include \"shared.glsl\"\n";
+            for (std::size_t j = 0; j < HEADERS_PER_MODULE; ++j) {
+                module += std::format("#include \"module_{}/header_{}.glsl\"\n", i, j);
+                corpus.addInclude(std::format("module_{}/header_{}.glsl", i, j),
+                    generateShaderCode(HEADER_SIZE, static_cast<std::uint32_t>(i * HEADERS_PER_MODULE + j)));
+            }
+            corpus.addInclude(std::format("module_{}/module.glsl", i), module + generateShaderCode(HEADER_SIZE));
+        }
+        corpus.addSource("wide.glsl", modules + generateShaderCode(HEADER_SIZE));
+    }
+};
+
+static const ProcessorFixture& getFixture() {
+    static const ProcessorFixture fixture;
+    return fixture;
+}
+
+static void processShader(BenchmarkState& state, const std::string& shader) {
+    GLSLSourceProcessor processor(FileSourceProvider(CachedFileProvider{},
+        SplitDirectories(getFixture().corpus.getRoot())));
+    processor.define("DEFINITION_A", 1);
+    processor.define("DEFINITION_B");
+
+    state.setBytesPerIteration(processor.getShaderSource(shader)->size());
+    while (state.keepRunning()) {
+        doNotOptimize(processor.getShaderSource(shader));
+    }
+}
+
+// A shader without any includes
+GLSL_BENCHMARK(processLeafShader) {
+    processShader(state, "leaf.glsl");
+}
+
+// A shader consisting mostly of includes, which themselves include nothing
+GLSL_BENCHMARK(processIncludingShader) {
+    processShader(state, "includes.glsl");
+}
+
+static void processUncached(BenchmarkState& state, std::shared_ptr<ThreadPool> pool) {
+    GLSLSourceProcessor processor(FileSourceProvider(SillyFileProvider{},
+        SplitDirectories(getFixture().corpus.getRoot())));
+    processor.setThreadPool(std::move(pool));
+
+    state.setBytesPerIteration(processor.getShaderSource("wide.glsl")->size());
+    while (state.keepRunning()) {
+        doNotOptimize(processor.getShaderSource("wide.glsl"));
+    }
+}
+
+// A shader of many include subtrees, whose files are all read from disk on the calling thread
+GLSL_BENCHMARK(processWideShader) {
+    processUncached(state, nullptr);
+}
+
+// The same shader, with the files read ahead on all cores
+GLSL_BENCHMARK(processWideShaderPrefetched) {
+    processUncached(state, std::make_shared<ThreadPool>());
+}
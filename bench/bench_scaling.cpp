@@ -0,0 +1,194 @@
+// MIT License
+//
+// Copyright (c) 2026 Levin Tertilt
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "bench.h"
+#include "corpus.h"
+
+#include <algorithm>
+#include <atomic>
+#include <barrier>
+#include <thread>
+#include <vector>
+
+#include <glsl/glsl_source_processor.h>
+
+// Processes a corpus of shaders on a growing number of threads, either with one provider shared by all threads as in
+// glsl_sp_cli or with a provider per thread. Every thread uses its own processor and all caches are warm, so the
+// results show how far the provider synchronization and the allocator scale. The efficiency is the speedup over a
+// single thread divided by the number of threads. If the single thread benchmark is filtered out, its baseline is
+// measured separately
+
+constexpr std::size_t SHADER_COUNT = 32;
+constexpr std::size_t HEADER_COUNT = 24;
+constexpr std::size_t INCLUDES_PER_SHADER = 8;
+// Shaders processed per iteration, enough to hide the synchronization of the threads between iterations
+constexpr std::size_t SHADERS_PER_ITERATION = 4 * SHADER_COUNT;
+
+struct ScalingFixture {
+    TemporaryCorpus corpus;
+    std::vector<std::string> shaders;
+
+    ScalingFixture() :
+        corpus("scaling") {
+        for (std::size_t i = 0; i < HEADER_COUNT; ++i) {
+            corpus.addInclude(std::format("header_{}.glsl", i),
+                generateShaderCode(2048, static_cast<std::uint32_t>(i)));
+        }
+        for (std::size_t i = 0; i < SHADER_COUNT; ++i) {
+            std::string source;
+            for (std::size_t j = 0; j < INCLUDES_PER_SHADER; ++j) {
+                source += std::format("#include \"header_{}.glsl\"\n", (i * 3 + j * 5) % HEADER_COUNT);
+            }
+            source += generateShaderCode(2048, static_cast<std::uint32_t>(HEADER_COUNT + i));
+            shaders.push_back(std::format("shader_{}.glsl", i));
+            corpus.addSource(shaders.back(), source);
+        }
+    }
+};
+
+static const ScalingFixture& getFixture() {
+    static const ScalingFixture fixture;
+    return fixture;
+}
+
+using SharedScalingProvider =
+    SharedSourceProvider<FileSourceProvider<SynchronizedFileProvider<SmartCachedFileProvider>>>;
+using LocalScalingProvider = FileSourceProvider<SmartCachedFileProvider>;
+
+// Processes shaders until all of the iteration are taken, returns the amount of generated bytes
+template<SourceProvider PROVIDER>
+static std::uint64_t processShaders(const GLSLSourceProcessor<PROVIDER>& processor, std::atomic<std::size_t>& next) {
+    const ScalingFixture& fixture = getFixture();
+    std::uint64_t bytes = 0;
+    for (std::size_t i = next++; i < SHADERS_PER_ITERATION; i = next++) {
+        std::optional<std::string> source = processor.getShaderSource(fixture.shaders[i % SHADER_COUNT]);
+        bytes += source->size();
+        doNotOptimize(source);
+    }
+    return bytes;
+}
+
+// The single thread results of the last run per provider kind, as the baseline of the efficiency
+static double singleThreadNs[2] = {};
+
+// Runs the timed loop on the given number of threads, returns the time per iteration
+template<bool SHARED>
+static double measureScaling(BenchmarkState& state, unsigned threadCount) {
+    const ScalingFixture& fixture = getFixture();
+    SharedScalingProvider sharedProvider(FileSourceProvider(SynchronizedFileProvider<SmartCachedFileProvider>{},
+        SplitDirectories(fixture.corpus.getRoot())));
+    sharedProvider.get().getImpl().withImpl([](const SmartCachedFileProvider& cache) { cache.beginBatch(); });
+
+    auto makeProcessor = [&] {
+        if constexpr (SHARED) {
+            return GLSLSourceProcessor<SharedScalingProvider>(sharedProvider);
+        } else {
+            GLSLSourceProcessor processor(LocalScalingProvider(SmartCachedFileProvider{},
+                SplitDirectories(fixture.corpus.getRoot())));
+            processor.getSourceProvider().getImpl().beginBatch();
+            return processor;
+        }
+    };
+
+    // The threads meet before and after every iteration, the calling thread takes part in the work as well
+    std::atomic<std::size_t> next = 0;
+    std::atomic<bool> running = true;
+    std::barrier sync(threadCount);
+    auto work = [&](const auto& processor) {
+        std::atomic<std::size_t> warmUp = 0;
+        processShaders(processor, warmUp);
+        sync.arrive_and_wait();
+        while (true) {
+            sync.arrive_and_wait();
+            if (!running) {
+                return;
+            }
+            processShaders(processor, next);
+            sync.arrive_and_wait();
+        }
+    };
+
+    std::vector<std::jthread> workers;
+    for (unsigned i = 1; i < threadCount; ++i) {
+        workers.emplace_back([&] { work(makeProcessor()); });
+    }
+
+    auto processor = makeProcessor();
+    std::atomic<std::size_t> warmUp = 0;
+    state.setBytesPerIteration(processShaders(processor, warmUp));
+    sync.arrive_and_wait();
+    while (state.keepRunning()) {
+        next = 0;
+        sync.arrive_and_wait();
+        processShaders(processor, next);
+        sync.arrive_and_wait();
+    }
+    running = false;
+    sync.arrive_and_wait();
+
+    return static_cast<double>(state.getElapsed().count()) / static_cast<double>(state.getIterations());
+}
+
+// Returns the single thread baseline, which is measured on its own if the single thread benchmark has not run
+template<bool SHARED>
+static double getSingleThreadNs() {
+    constexpr auto MIN_TIME = std::chrono::milliseconds(200);
+
+    for (std::uint64_t iterations = 1; singleThreadNs[SHARED] == 0; iterations *= 2) {
+        BenchmarkState state(iterations);
+        double ns = measureScaling<SHARED>(state, 1);
+        if (state.getElapsed() >= MIN_TIME) {
+            singleThreadNs[SHARED] = ns;
+        }
+    }
+    return singleThreadNs[SHARED];
+}
+
+template<bool SHARED>
+static void runScaling(BenchmarkState& state, unsigned threadCount) {
+    double ns = measureScaling<SHARED>(state, threadCount);
+    if (threadCount == 1) {
+        singleThreadNs[SHARED] = ns;
+    }
+    state.setCounter("threads", threadCount);
+    state.setCounter("efficiency", getSingleThreadNs<SHARED>() / (ns * threadCount));
+}
+
+// Registers the thread counts 1, 2, 4, ... up to all cores
+[[maybe_unused]] static const bool scalingRegistered = [] {
+    unsigned maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<unsigned> threadCounts;
+    for (unsigned threads = 1; threads < maxThreads; threads *= 2) {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(maxThreads);
+
+    for (unsigned threads : threadCounts) {
+        registerBenchmark(std::format("threadScalingShared/{}", threads), [threads](BenchmarkState& state) {
+            runScaling<true>(state, threads);
+        });
+        registerBenchmark(std::format("threadScalingPerThread/{}", threads), [threads](BenchmarkState& state) {
+            runScaling<false>(state, threads);
+        });
+    }
+    return true;
+}();
@@ -0,0 +1,357 @@
+// MIT License
+//
+// Copyright (c) 2026 Levin Tertilt
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Compares two result files of glsl_sp_bench --json and fails if a benchmark got slower. A difference is only
+// reported if it exceeds both the relative threshold and the noise of the runs, estimated by three times the sum of
+// the median absolute deviations of both files. Files should therefore be recorded with --repetitions, e.g. 5.
+// Benchmarks of the baseline that are missing from the current file fail the comparison as well. Hardware events
+// recorded with --perf are listed for both files, but do not decide the result
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+struct JSONValue {
+    enum class Type {
+        Null,
+        Boolean,
+        Number,
+        String,
+        Array,
+        Object
+    };
+
+    Type type = Type::Null;
+    bool boolean = false;
+    double number = 0.0;
+    std::string string;
+    std::vector<JSONValue> array;
+    std::vector<std::pair<std::string, JSONValue>> object;
+
+    [[nodiscard]] const JSONValue* find(std::string_view key) const {
+        for (const auto& [name, value] : object) {
+            if (name == key) {
+                return &value;
+            }
+        }
+        return nullptr;
+    }
+};
+
+/// A minimal JSON parser, sufficient for the files written by glsl_sp_bench
+class JSONParser {
+public:
+    explicit JSONParser(std::string_view text) :
+        text_(text) {}
+
+    std::optional<JSONValue> parse() {
+        std::optional<JSONValue> value = parseValue();
+        skipWhitespace();
+        if (position_ != text_.size()) {
+            return std::nullopt;
+        }
+        return value;
+    }
+
+private:
+    void skipWhitespace() {
+        constexpr std::string_view WHITESPACE = " \t\r\n";
+        while (position_ < text_.size() && WHITESPACE.find(text_[position_]) != std::string_view::npos) {
+            ++position_;
+        }
+    }
+
+    bool consume(std::string_view token) {
+        skipWhitespace();
+        if (text_.substr(position_).starts_with(token)) {
+            position_ += token.size();
+            return true;
+        }
+        return false;
+    }
+
+    std::optional<JSONValue> parseValue() {
+        skipWhitespace();
+        if (position_ >= text_.size()) {
+            return std::nullopt;
+        }
+
+        JSONValue value;
+        char c = text_[position_];
+        if (c == '{') {
+            value.type = JSONValue::Type::Object;
+            ++position_;
+            if (consume("}")) {
+                return value;
+            }
+            do {
+                skipWhitespace();
+                std::optional<std::string> key = parseString();
+                if (!key.has_value() || !consume(":")) {
+                    return std::nullopt;
+                }
+                std::optional<JSONValue> member = parseValue();
+                if (!member.has_value()) {
+                    return std::nullopt;
+                }
+                value.object.emplace_back(std::move(*key), std::move(*member));
+            } while (consume(","));
+            return consume("}") ? std::make_optional(std::move(value)) : std::nullopt;
+        } else if (c == '[') {
+            value.type = JSONValue::Type::Array;
+            ++position_;
+            if (consume("]")) {
+                return value;
+            }
+            do {
+                std::optional<JSONValue> element = parseValue();
+                if (!element.has_value()) {
+                    return std::nullopt;
+                }
+                value.array.push_back(std::move(*element));
+            } while (consume(","));
+            return consume("]") ? std::make_optional(std::move(value)) : std::nullopt;
+        } else if (c == '"') {
+            std::optional<std::string> string = parseString();
+            if (!string.has_value()) {
+                return std::nullopt;
+            }
+            value.type = JSONValue::Type::String;
+            value.string = std::move(*string);
+            return value;
+        } else if (consume("true")) {
+            value.type = JSONValue::Type::Boolean;
+            value.boolean = true;
+            return value;
+        } else if (consume("false")) {
+            value.type = JSONValue::Type::Boolean;
+            value.boolean = false;
+            return value;
+        } else if (consume("null")) {
+            return value;
+        }
+
+        value.type = JSONValue::Type::Number;
+        auto [end, ec] = std::from_chars(text_.data() + position_, text_.data() + text_.size(), value.number);
+        if (ec != std::errc{}) {
+            return std::nullopt;
+        }
+        position_ = static_cast<std::size_t>(end - text_.data());
+        return value;
+    }
+
+    // Only escapes of ASCII characters are supported
+    std::optional<std::string> parseString() {
+        if (position_ >= text_.size() || text_[position_] != '"') {
+            return std::nullopt;
+        }
+        std::string string;
+        for (++position_; position_ < text_.size(); ++position_) {
+            char c = text_[position_];
+            if (c == '"') {
+                ++position_;
+                return string;
+            }
+            if (c != '\\') {
+                string += c;
+                continue;
+            }
+            if (++position_ >= text_.size()) {
+                return std::nullopt;
+            }
+            switch (char escaped = text_[position_]) {
+                case 'n': string += '\n'; break;
+                case 't': string += '\t'; break;
+                case 'r': string += '\r'; break;
+                case 'b': string += '\b'; break;
+                case 'f': string += '\f'; break;
+                case 'u': {
+                    unsigned code = 0;
+                    const char* digits = text_.data() + position_ + 1;
+                    if (position_ + 4 >= text_.size() ||
+                        std::from_chars(digits, digits + 4, code, 16).ec != std::errc{}) {
+                        return std::nullopt;
+                    }
+                    string += static_cast<char>(code);
+                    position_ += 4;
+                    break;
+                }
+                default: string += escaped; break;
+            }
+        }
+        return std::nullopt;
+    }
+
+    std::string_view text_;
+    std::size_t position_ = 0;
+};
+
+struct BenchmarkEntry {
+    std::string name;
+    // The median and the median absolute deviation in nanoseconds per iteration
+    double median;
+    double mad;
+    // The hardware events per iteration, empty if they were not counted
+    std::vector<std::pair<std::string, double>> perf;
+};
+
+struct BenchmarkFile {
+    JSONValue context;
+    std::vector<BenchmarkEntry> benchmarks;
+};
+
+static std::optional<BenchmarkFile> readBenchmarkFile(const std::string& filepath) {
+    std::ifstream file(filepath, std::ios::binary);
+    std::stringstream contents;
+    contents << file.rdbuf();
+    std::optional<JSONValue> root = JSONParser(contents.str()).parse();
+    const JSONValue* benchmarks = root.has_value() ? root->find("benchmarks") : nullptr;
+    if (benchmarks == nullptr || benchmarks->type != JSONValue::Type::Array) {
+        std::cerr << "Failed to read benchmark results: " << filepath << std::endl;
+        return std::nullopt;
+    }
+
+    BenchmarkFile result;
+    if (const JSONValue* context = root->find("context")) {
+        result.context = *context;
+    }
+    for (const JSONValue& benchmark : benchmarks->array) {
+        const JSONValue* name = benchmark.find("name");
+        const JSONValue* median = benchmark.find("median_ns");
+        const JSONValue* mad = benchmark.find("mad_ns");
+        // Medians that were not finite are written as null
+        if (name == nullptr || median == nullptr || mad == nullptr || median->type != JSONValue::Type::Number ||
+            mad->type != JSONValue::Type::Number) {
+            std::cerr << "Incomplete benchmark in: " << filepath << std::endl;
+            return std::nullopt;
+        }
+        BenchmarkEntry& entry = result.benchmarks.emplace_back(BenchmarkEntry{name->string, median->number,
+            mad->number, {}});
+        // Files written before the events were exported have no perf object
+        if (const JSONValue* perf = benchmark.find("perf")) {
+            for (const auto& [event, value] : perf->object) {
+                if (value.type == JSONValue::Type::Number) {
+                    entry.perf.emplace_back(event, value.number);
+                }
+            }
+        }
+    }
+    return result;
+}
+
+static void printUsage() {
+    std::cerr << "Usage: glsl_sp_bench_compare [--threshold <percent>] <baseline.json> <current.json>\n"
+                 "Fails if a benchmark is slower than in the baseline by more than the threshold (default: 5)\n"
+                 "and the noise of both runs, or if a benchmark of the baseline is missing\n";
+}
+
+int main(int argc, char** argv) {
+    double threshold = 5.0;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        if (arg == "--threshold" && i + 1 < argc) {
+            std::string_view value = argv[++i];
+            if (std::from_chars(value.data(), value.data() + value.size(), threshold).ec != std::errc{}) {
+                printUsage();
+                return 2;
+            }
+        } else if (arg.starts_with("--")) {
+            printUsage();
+            return 2;
+        } else {
+            files.emplace_back(arg);
+        }
+    }
+    if (files.size() != 2) {
+        printUsage();
+        return 2;
+    }
+
+    std::optional<BenchmarkFile> baseline = readBenchmarkFile(files[0]);
+    std::optional<BenchmarkFile> current = readBenchmarkFile(files[1]);
+    if (!baseline.has_value() || !current.has_value()) {
+        return 2;
+    }
+
+    // Results are only comparable on the same machine and build
+    for (std::string_view key : {"host", "cpu", "compiler"}) {
+        const JSONValue* before = baseline->context.find(key);
+        const JSONValue* after = current->context.find(key);
+        if (before != nullptr && after != nullptr && before->string != after->string) {
+            std::cout << std::format("Warning: {} differs: {} -> {}\n", key, before->string, after->string);
+        }
+    }
+
+    std::cout << std::format("{:<40} {:>14} {:>14} {:>9} {:>9}\n", "benchmark", "baseline ns", "current ns", "change",
+        "noise");
+    bool regressed = false;
+    for (const BenchmarkEntry& entry : current->benchmarks) {
+        const auto& [name, median, mad, perf] = entry;
+        auto before = std::ranges::find(baseline->benchmarks, name, &BenchmarkEntry::name);
+        if (before == baseline->benchmarks.end()) {
+            std::cout << std::format("{:<40} {:>14} {:>14.1f}   new\n", name, "-", median);
+            continue;
+        }
+
+        double baselineMedian = before->median;
+        double baselineMad = before->mad;
+        double change = baselineMedian > 0 ? 100.0 * (median - baselineMedian) / baselineMedian : 0.0;
+        double noise = baselineMedian > 0 ? 100.0 * 3.0 * (mad + baselineMad) / baselineMedian : 0.0;
+        std::string_view verdict = "";
+        if (std::abs(change) > threshold && std::abs(change) > noise) {
+            verdict = change > 0 ? "  REGRESSION" : "  improved";
+            regressed |= change > 0;
+        }
+        std::cout << std::format("{:<40} {:>14.1f} {:>14.1f} {:>+8.1f}% {:>8.1f}%{}\n", name, baselineMedian, median,
+            change, noise, verdict);
+
+        for (const auto& [event, count] : perf) {
+            auto baselineCount = std::ranges::find(before->perf, event, &std::pair<std::string, double>::first);
+            if (baselineCount != before->perf.end()) {
+                double eventChange = baselineCount->second > 0 ?
+                    100.0 * (count - baselineCount->second) / baselineCount->second : 0.0;
+                std::cout << std::format("  {:<38} {:>14.1f} {:>14.1f} {:>+8.1f}%\n", event + "/op",
+                    baselineCount->second, count, eventChange);
+            }
+        }
+    }
+
+    // A benchmark that disappeared, e.g. because it crashed or was renamed, would otherwise pass unnoticed
+    bool missing = false;
+    for (const BenchmarkEntry& entry : baseline->benchmarks) {
+        if (std::ranges::find(current->benchmarks, entry.name, &BenchmarkEntry::name) == current->benchmarks.end()) {
+            std::cout << std::format("{:<40} {:>14.1f} {:>14}   MISSING\n", entry.name, entry.median, "-");
+            missing = true;
+        }
+    }
+    return regressed || missing ? 1 : 0;
+}
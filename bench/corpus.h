@@ -0,0 +1,93 @@
+// MIT License
+//
+// Copyright (c) 2026 Levin Tertilt
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <random>
+#include <string>
+#include <string_view>
+
+/// A temporary shader tree in the layout expected by SplitDirectories, which is removed on destruction. The directory
+/// name has a random suffix, so concurrent benchmark runs do not overwrite each other's corpus
+class TemporaryCorpus {
+public:
+    explicit TemporaryCorpus(std::string_view name) :
+        root_(std::filesystem::temp_directory_path() /
+            std::format("glsl_sp_bench_{}_{:08x}", name, std::random_device{}())) {
+        std::filesystem::remove_all(root_);
+        std::filesystem::create_directories(root_ / "src");
+        std::filesystem::create_directories(root_ / "include");
+    }
+    ~TemporaryCorpus() {
+        std::error_code ec;
+        std::filesystem::remove_all(root_, ec);
+    }
+
+    TemporaryCorpus(const TemporaryCorpus&) = delete;
+    TemporaryCorpus& operator=(const TemporaryCorpus&) = delete;
+
+    void addSource(std::string_view name, std::string_view content) const { write(root_ / "src" / name, content); }
+    void addInclude(std::string_view name, std::string_view content) const {
+        write(root_ / "include" / name, content);
+    }
+
+    [[nodiscard]] const std::filesystem::path& getRoot() const { return root_; }
+
+private:
+    static void write(const std::filesystem::path& filepath, std::string_view content) {
+        std::filesystem::create_directories(filepath.parent_path());
+        std::ofstream file(filepath, std::ios::binary);
+        file.write(content.data(), static_cast<std::streamsize>(content.size()));
+    }
+
+    std::filesystem::path root_;
+};
+
+/// Generates roughly `size` bytes of GLSL-like code without any include directives
+inline std::string generateShaderCode(std::size_t size, std::uint32_t seed = 0) {
+    constexpr std::string_view LINES[] = {
+        "vec4 color = texture(u_Texture, fIn.texCoords);",
+        "float luminance = dot(color.rgb, vec3(0.2126, 0.7152, 0.0722));",
+        "#ifdef USE_ALPHA_CUTOUT",
+        "#endif",
+        "uniform sampler2D u_Texture;",
+        "",
+        "    out_Color = mix(color, vec4(luminance), 0.5);",
+        "// Computes the lighting contribution of a single light source",
+        "layout (std140, binding = 0) uniform Camera { mat4 view; mat4 projection; };",
+    };
+
+    std::mt19937 random(seed);
+    std::uniform_int_distribution<std::size_t> distribution(0, std::size(LINES) - 1);
+
+    std::string code;
+    code.reserve(size + 128);
+    while (code.size() < size) {
+        code += LINES[distribution(random)];
+        code += '\n';
+    }
+    return code;
+}
@@ -0,0 +1,196 @@
+// MIT License
+//
+// Copyright (c) 2026 Levin Tertilt
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#ifdef __linux__
+#include <cerrno>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+enum class PerfEvent {
+    Cycles,
+    Instructions,
+    CacheMisses,
+    BranchMisses
+};
+
+inline constexpr std::size_t PERF_EVENT_COUNT = 4;
+inline constexpr std::array<std::string_view, PERF_EVENT_COUNT> PERF_EVENT_NAMES = {
+    "cycles", "instructions", "cache-misses", "branch-misses"
+};
+
+/// The counted events, events that are not supported by the machine are empty
+using PerfCounts = std::array<std::optional<double>, PERF_EVENT_COUNT>;
+
+/// Hardware performance counters of the calling thread and all threads it creates after opening them, e.g. the workers
+/// of a thread pool, read through perf_event_open. Threads that already exist when the counters are opened are not
+/// counted. Only user space is counted, as this is permitted with the default perf_event_paranoid setting. Every event
+/// is opened on its own instead of as a group, so that a single unsupported event, e.g. in a virtual machine, does not
+/// disable the others
+class PerfCounters {
+public:
+    /// Opens all supported events, returns nullopt and the reason if none is available
+    static std::optional<PerfCounters> open(std::string* error = nullptr) {
+#ifdef __linux__
+        constexpr std::array<std::uint64_t, PERF_EVENT_COUNT> CONFIGS = {
+            PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES,
+            PERF_COUNT_HW_BRANCH_MISSES
+        };
+
+        PerfCounters counters;
+        bool any = false;
+        for (std::size_t i = 0; i < PERF_EVENT_COUNT; ++i) {
+            perf_event_attr attributes{};
+            attributes.type = PERF_TYPE_HARDWARE;
+            attributes.size = sizeof(attributes);
+            attributes.config = CONFIGS[i];
+            attributes.disabled = 1;
+            attributes.exclude_kernel = 1;
+            attributes.exclude_hv = 1;
+            // Threads created later inherit the counters, reading and the ioctls then cover them as well
+            attributes.inherit = 1;
+            // Scales the values if the kernel has to multiplex more events than there are hardware counters
+            attributes.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+            counters.fds_[i] = static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, -1,
+                PERF_FLAG_FD_CLOEXEC));
+            if (counters.fds_[i] >= 0) {
+                any = true;
+            } else if (error != nullptr && error->empty()) {
+                *error = std::strerror(errno);
+                if (errno == EACCES || errno == EPERM) {
+                    *error += " (see /proc/sys/kernel/perf_event_paranoid)";
+                } else if (errno == ENOENT || errno == EOPNOTSUPP) {
+                    *error += " (the hardware events are not exposed, e.g. in a virtual machine)";
+                }
+            }
+        }
+        if (any) {
+            return counters;
+        }
+#else
+        if (error != nullptr) {
+            *error = "perf_event_open is only available on Linux";
+        }
+#endif
+        return std::nullopt;
+    }
+
+    PerfCounters(PerfCounters&& other) noexcept :
+        fds_(std::exchange(other.fds_, INVALID_FDS)),
+        starts_(other.starts_),
+        counts_(other.counts_) {}
+    PerfCounters& operator=(PerfCounters&& other) noexcept {
+        std::swap(fds_, other.fds_);
+        std::swap(starts_, other.starts_);
+        std::swap(counts_, other.counts_);
+        return *this;
+    }
+    ~PerfCounters() {
+#ifdef __linux__
+        for (int fd : fds_) {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+#endif
+    }
+
+    /// Starts counting. The current values are taken as the baseline, since resetting the counters would not clear the
+    /// counts that threads created and exited since opening them have added
+    void start() {
+#ifdef __linux__
+        starts_ = readSamples();
+        for (int fd : fds_) {
+            if (fd >= 0) {
+                ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+            }
+        }
+#endif
+    }
+
+    void stop() {
+#ifdef __linux__
+        for (int fd : fds_) {
+            if (fd >= 0) {
+                ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+            }
+        }
+
+        std::array<std::optional<Sample>, PERF_EVENT_COUNT> ends = readSamples();
+        for (std::size_t i = 0; i < PERF_EVENT_COUNT; ++i) {
+            counts_[i].reset();
+            if (!starts_[i].has_value() || !ends[i].has_value() || ends[i]->timeRunning <= starts_[i]->timeRunning) {
+                continue;
+            }
+            // Extrapolated to the whole time, in case the event was only counted part of it
+            counts_[i] = static_cast<double>(ends[i]->value - starts_[i]->value) *
+                static_cast<double>(ends[i]->timeEnabled - starts_[i]->timeEnabled) /
+                static_cast<double>(ends[i]->timeRunning - starts_[i]->timeRunning);
+        }
+#endif
+    }
+
+    /// Returns the events counted between the last start and stop
+    [[nodiscard]] const PerfCounts& read() const { return counts_; }
+
+private:
+    static constexpr std::array<int, PERF_EVENT_COUNT> INVALID_FDS = {-1, -1, -1, -1};
+
+    // The value of a counter, including the threads that inherited it, and how long it was enabled and running
+    struct Sample {
+        std::uint64_t value;
+        std::uint64_t timeEnabled;
+        std::uint64_t timeRunning;
+    };
+
+    PerfCounters() = default;
+
+    [[nodiscard]] std::array<std::optional<Sample>, PERF_EVENT_COUNT> readSamples() const {
+        std::array<std::optional<Sample>, PERF_EVENT_COUNT> samples;
+#ifdef __linux__
+        for (std::size_t i = 0; i < PERF_EVENT_COUNT; ++i) {
+            Sample sample{};
+            if (fds_[i] >= 0 && ::read(fds_[i], &sample, sizeof(sample)) == sizeof(sample)) {
+                samples[i] = sample;
+            }
+        }
+#endif
+        return samples;
+    }
+
+    std::array<int, PERF_EVENT_COUNT> fds_ = INVALID_FDS;
+    std::array<std::optional<Sample>, PERF_EVENT_COUNT> starts_;
+    PerfCounts counts_;
+};
@@ -0,0 +1,134 @@
+// MIT License
+//
+// Copyright (c) 2026 Levin Tertilt
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Runs inputs through the fuzzing harness without libFuzzer, e.g. to replay inputs found by the fuzzer or with
+// compilers that do not support it. Without arguments, a set of generated pathological inputs is processed instead.
+// Prints the time per byte of every input and fails if any of them is slow
+
+#include "fuzz_processor.h"
+
+#include <format>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+struct GeneratedInput {
+    const char* name;
+    std::function<std::string()> generate;
+};
+
+static std::string generateIncludes(std::size_t first, std::size_t count) {
+    std::string includes;
+    for (std::size_t i = first; i < first + count; ++i) {
+        includes += std::format("#include \"{}\"\n", i);
+    }
+    return includes;
+}
+
+static const GeneratedInput GENERATED_INPUTS[] = {
+    {"deepIncludeChain", [] {
+        std::string input;
+        for (std::size_t i = 1; i <= 4000; ++i) {
+            input += std::format("#include \"{}\"\nfloat value{};\n", i, i);
+            input += '\0';
+        }
+        return input + "// end of the chain";
+    }},
+    {"longLine", [] {
+        return "float value = " + std::string(8 << 20, '1') + ";\n";
+    }},
+    {"noNewlines", [] {
+        return std::string(8 << 20, 'x');
+    }},
+    {"longIncludeDirective", [] {
+        return "#include \"" + std::string(8 << 20, 'x');
+    }},
+    {"manyIncludes", [] {
+        std::string input = generateIncludes(1, 20000);
+        for (std::size_t i = 1; i <= 20000; ++i) {
+            input += '\0';
+            input += "float value;\n";
+        }
+        return input;
+    }},
+    {"manyRepeatedIncludes", [] {
+        std::string input;
+        for (std::size_t i = 0; i < 200000; ++i) {
+            input += "#include \"1\"\n";
+        }
+        return input + '\0' + "float value;\n";
+    }},
+    // Every header includes all headers after it, the longest possible include chain without cycles
+    {"everyHeaderIncludesAllAfter", [] {
+        constexpr std::size_t HEADER_COUNT = 700;
+        std::string input = generateIncludes(1, HEADER_COUNT);
+        for (std::size_t i = 1; i <= HEADER_COUNT; ++i) {
+            input += '\0';
+            input += generateIncludes(i + 1, HEADER_COUNT - i);
+        }
+        return input;
+    }},
+    {"includeCycle", [] {
+        std::string input;
+        for (std::size_t i = 1; i <= 4000; ++i) {
+            input += std::format("#include \"{}\"\n", i);
+            input += '\0';
+        }
+        return input + "#include \"1\"\n";
+    }},
+    {"manyEmptyLines", [] {
+        return std::string(8 << 20, '\n');
+    }},
+};
+
+static bool report(std::string_view name, const FuzzResult& result) {
+    bool slow = isSlow(result);
+    std::cout << std::format("{:<28} {:>10} bytes {:>12} bytes out {:>10.3f} ms {:>8.1f} ns/byte {}{}\n", name,
+        result.inputBytes, result.outputBytes, static_cast<double>(result.elapsed.count()) / 1e6,
+        result.getNsPerByte(), result.success ? "ok" : "failed", slow ? "  SLOW" : "");
+    return !slow;
+}
+
+int main(int argc, char** argv) {
+    bool success = true;
+    if (argc == 1) {
+        for (const GeneratedInput& input : GENERATED_INPUTS) {
+            success &= report(input.name, processFuzzInput(input.generate()));
+        }
+        return success ? 0 : 1;
+    }
+
+    for (int i = 1; i < argc; ++i) {
+        std::ifstream file(argv[i], std::ios::binary);
+        if (!file.is_open()) {
+            std::cerr << "Failed to open: " << argv[i] << std::endl;
+            return 1;
+        }
+        std::stringstream contents;
+        contents << file.rdbuf();
+        success &= report(argv[i], processFuzzInput(contents.str()));
+    }
+    return success ? 0 : 1;
+}
@@ -0,0 +1,80 @@
+// MIT License
+//
+// Copyright (c) 2026 Levin Tertilt
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// A libFuzzer compatible harness looking for inputs with super-linear processing time, see fuzz_processor.h for the
+// input layout. Slow inputs abort the process, so that libFuzzer stores them like crashes. Unbounded memory usage is
+// found through the -rss_limit_mb and -malloc_limit_mb options of libFuzzer
+
+#include "fuzz_processor.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include <glsl/glsl_source_processor.h>
+
+FuzzResult processFuzzInput(std::string_view input) {
+    MemorySourceProvider provider;
+    std::size_t index = 0;
+    for (std::size_t start = 0; start <= input.size(); ++index) {
+        std::size_t end = std::min(input.find('\0', start), input.size());
+        provider.addSource(index == 0 ? SourceType::Source : SourceType::Include, std::to_string(index),
+            std::string(input.substr(start, end - start)));
+        start = end + 1;
+    }
+
+    GLSLSourceProcessor processor(std::move(provider), "#version 450 core", DISABLED_LOGGING);
+    auto start = std::chrono::steady_clock::now();
+    std::optional<std::string> output = processor.getShaderSource("0");
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    return {output.has_value(), input.size(), output.has_value() ? output->size() : 0,
+        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed)};
+}
+
+static double getEnvironmentValue(const char* name, double defaultValue) {
+    const char* value = std::getenv(name);
+    double result = defaultValue;
+    if (value != nullptr) {
+        std::from_chars(value, value + std::char_traits<char>::length(value), result);
+    }
+    return result;
+}
+
+bool isSlow(const FuzzResult& result) {
+    static const double minMs = getEnvironmentValue("GLSL_SP_FUZZ_MIN_MS", 10.0);
+    static const double maxNsPerByte = getEnvironmentValue("GLSL_SP_FUZZ_MAX_NS_PER_BYTE", 100.0);
+    return static_cast<double>(result.elapsed.count()) >= minMs * 1e6 && result.getNsPerByte() > maxNsPerByte;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* data, std::size_t size) {
+    FuzzResult result = processFuzzInput(std::string_view(reinterpret_cast<const char*>(data), size));
+    if (isSlow(result)) {
+        std::fprintf(stderr, "Slow input: %zu bytes took %.3f ms (%.1f ns/byte)\n", result.inputBytes,
+            static_cast<double>(result.elapsed.count()) / 1e6, result.getNsPerByte());
+        std::abort();
+    }
+    return 0;
+}
@@ -0,0 +1,48 @@
+// MIT License
+//
+// Copyright (c) 2026 Levin Tertilt
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <string_view>
+
+/// The result of processing one fuzzer input
+struct FuzzResult {
+    bool success;
+    std::size_t inputBytes;
+    std::size_t outputBytes;
+    std::chrono::nanoseconds elapsed;
+
+    [[nodiscard]] double getNsPerByte() const {
+        return static_cast<double>(elapsed.count()) / static_cast<double>(inputBytes == 0 ? 1 : inputBytes);
+    }
+};
+
+/// Processes an input, which contains the files separated by '\0'. The first file is the shader "0", the following
+/// files are the includes "1", "2", ..., so that the fuzzer only needs to find short include directives
+FuzzResult processFuzzInput(std::string_view input);
+
+/// Returns whether processing took suspiciously long for the size of the input. Inputs are slow, if they take longer
+/// than GLSL_SP_FUZZ_MIN_MS (default: 10) and more than GLSL_SP_FUZZ_MAX_NS_PER_BYTE (default: 100) per input byte.
+/// The minimum duration keeps small inputs from being reported due to noise
+bool isSlow(const FuzzResult& result);
@@ -0,0 +1,201 @@
+// MIT License
+//
+// Copyright (c) 2026 Levin Tertilt
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "glsl_source_processor.h"
+
+/// A shader to process in a batch. Its definitions are added to those of the processor, which are emitted first
+struct BatchJob {
+    std::string shader;
+    std::vector<std::pair<std::string, std::string>> definitions;
+};
+
+/// A processed shader of a batch, handed to the callback of processBatch. The source is released once the callback
+/// returns, unless the callback moves it out
+struct BatchResult {
+    // The position of the job in the batch
+    std::size_t index;
+    // Empty if the shader could not be processed
+    std::optional<std::string> source;
+    std::vector<std::string> includedFiles;
+};
+
+/// The thread on which processBatch invokes its callback
+enum class BatchCallbackThread {
+    // The worker that processed the shader, so callbacks of different shaders run concurrently
+    Worker,
+    // The thread that called processBatch, which does not process shaders itself then
+    Caller,
+};
+
+/// A SourceProvider whose copies refer to one shared provider, like SharedSourceProvider. processBatch requires it,
+/// since every worker processes with its own copy of the processor, and independent copies would neither share a cache
+/// nor be guaranteed to be safe to use on different threads
+template<typename T>
+concept SharedSourceProviderLike = SourceProvider<T> && requires(const T t)
+{
+    t.getShared();
+};
+
+struct BatchOptions {
+    unsigned threadCount = std::max(1u, std::thread::hardware_concurrency());
+    BatchCallbackThread callbackThread = BatchCallbackThread::Worker;
+    // Processed shaders that may wait for the calling thread before the workers pause, twice the threads if 0
+    std::size_t maxQueued = 0;
+    // If set, the contributions of all headers to the batch are added to the report
+    IncludeReport* report = nullptr;
+};
+
+/// Processes the shaders of all jobs on multiple threads and invokes the callback with every shader as soon as it is
+/// finished, in the order of completion. The batch never holds more sources than there are threads, plus the queued
+/// ones if the callback runs on the calling thread, so the memory stays bounded no matter the size of the batch.
+/// Returns the number of shaders that could not be processed.
+///
+/// Every worker uses its own copy of the processor, which shares the source provider with the others, so the shared
+/// provider has to support concurrent calls, e.g. a FileSourceProvider of a SynchronizedFileProvider. The statistics
+/// are counted by the copies and not added to the given processor. If the callback or the source provider throws, the
+/// jobs that have not been started are skipped and the first exception is rethrown once all workers have stopped
+template<SharedSourceProviderLike SOURCE_PROVIDER, TracingPolicy TRACING, std::invocable<BatchResult&> CALLBACK_FN>
+std::size_t processBatch(const GLSLSourceProcessor<SOURCE_PROVIDER, TRACING>& processor,
+    const std::vector<BatchJob>& jobs, CALLBACK_FN&& callback, const BatchOptions& options = {}) {
+    if (jobs.empty()) {
+        return 0;
+    }
+
+    std::vector<std::pair<std::string, std::string>> definitions(processor.getDefinitions().begin(),
+        processor.getDefinitions().end());
+    std::size_t workerCount = std::clamp<std::size_t>(options.threadCount, 1, jobs.size());
+    std::vector<IncludeReport> workerReports(options.report != nullptr ? workerCount : 0);
+    std::atomic<std::size_t> next = 0;
+    std::atomic<std::size_t> failed = 0;
+
+    // The processed shaders waiting for the calling thread
+    std::mutex mutex;
+    std::condition_variable queued;
+    std::condition_variable dequeued;
+    std::deque<BatchResult> queue;
+    std::size_t maxQueued = options.maxQueued > 0 ? options.maxQueued : 2 * workerCount;
+    // The first exception of a worker or the callback, which stops the batch
+    std::exception_ptr error;
+
+    auto stop = [&](std::exception_ptr exception) {
+        {
+            std::scoped_lock lock(mutex);
+            if (error == nullptr) {
+                error = std::move(exception);
+            }
+        }
+        next = jobs.size();
+        queued.notify_all();
+        dequeued.notify_all();
+    };
+
+    auto work = [&](std::size_t worker) {
+        // Exceptions would terminate the worker thread, so they are handed to the calling thread instead
+        try {
+            GLSLSourceProcessor<SOURCE_PROVIDER, TRACING> workerProcessor(processor);
+            IncludeReport* report = options.report != nullptr ? &workerReports[worker] : nullptr;
+            for (std::size_t index = next++; index < jobs.size(); index = next++) {
+                const BatchJob& job = jobs[index];
+                workerProcessor.undefAll();
+                for (const auto& [name, value] : definitions) {
+                    workerProcessor.define(std::string(name), value);
+                }
+                for (const auto& [name, value] : job.definitions) {
+                    workerProcessor.define(std::string(name), value);
+                }
+
+                BatchResult result{index, std::nullopt, {}};
+                result.source = report != nullptr ?
+                    workerProcessor.getShaderSource(job.shader, result.includedFiles, *report) :
+                    workerProcessor.getShaderSource(job.shader, result.includedFiles);
+                failed += result.source.has_value() ? 0 : 1;
+
+                if (options.callbackThread == BatchCallbackThread::Worker) {
+                    callback(result);
+                    continue;
+                }
+                {
+                    std::unique_lock lock(mutex);
+                    dequeued.wait(lock, [&] { return queue.size() < maxQueued || error != nullptr; });
+                    if (error != nullptr) {
+                        return;
+                    }
+                    queue.push_back(std::move(result));
+                }
+                queued.notify_one();
+            }
+        } catch (...) {
+            stop(std::current_exception());
+        }
+    };
+
+    {
+        std::vector<std::jthread> workers;
+        for (std::size_t i = 0; i < workerCount; ++i) {
+            workers.emplace_back(work, i);
+        }
+
+        if (options.callbackThread == BatchCallbackThread::Caller) {
+            // The workers are joined before the exception is rethrown, since they refer to the state of the batch
+            try {
+                for (std::size_t delivered = 0; delivered < jobs.size(); ++delivered) {
+                    std::unique_lock lock(mutex);
+                    queued.wait(lock, [&] { return !queue.empty() || error != nullptr; });
+                    if (error != nullptr) {
+                        break;
+                    }
+                    BatchResult result = std::move(queue.front());
+                    queue.pop_front();
+                    lock.unlock();
+                    dequeued.notify_one();
+                    callback(result);
+                }
+            } catch (...) {
+                stop(std::current_exception());
+            }
+        }
+    }
+
+    if (error != nullptr) {
+        std::rethrow_exception(error);
+    }
+    for (const IncludeReport& workerReport : workerReports) {
+        options.report->merge(workerReport);
+    }
+    return failed;
+}
@@ -0,0 +1,176 @@
+// MIT License
+//
+// Copyright (c) 2026 Levin Tertilt
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <list>
+
+#include "glsl_lz.h"
+#include "glsl_source_processor.h"
+
+/// An implementation that caches files like CachedFileProvider, but keeps them compressed in memory, for targets where
+/// memory matters more than the access latency. The most recently used compressed files are additionally kept
+/// uncompressed, so repeated accesses to the same includes do not have to decompress them each time
+template<TracingPolicy TRACING = NoTracing>
+class BasicCompressedCachedFileProvider {
+public:
+    explicit BasicCompressedCachedFileProvider(std::size_t hotSetSize = 16) :
+        hotSetSize_(hotSetSize) {}
+
+    // The hot index refers to the nodes of the hot set, so a copy has to index its own nodes. Moving a list keeps its
+    // nodes, which leaves the index of a moved provider valid
+    BasicCompressedCachedFileProvider(const BasicCompressedCachedFileProvider& other) :
+        hotSetSize_(other.hotSetSize_),
+        stats_(other.stats_),
+        cache_(other.cache_),
+        missing_(other.missing_),
+        hotSet_(other.hotSet_),
+        compressedSize_(other.compressedSize_),
+        uncompressedSize_(other.uncompressedSize_) { rebuildHotIndex(); }
+    BasicCompressedCachedFileProvider(BasicCompressedCachedFileProvider&&) = default;
+
+    BasicCompressedCachedFileProvider& operator=(const BasicCompressedCachedFileProvider& other) {
+        if (this != &other) {
+            hotSetSize_ = other.hotSetSize_;
+            stats_ = other.stats_;
+            cache_ = other.cache_;
+            missing_ = other.missing_;
+            hotSet_ = other.hotSet_;
+            compressedSize_ = other.compressedSize_;
+            uncompressedSize_ = other.uncompressedSize_;
+            rebuildHotIndex();
+        }
+        return *this;
+    }
+    BasicCompressedCachedFileProvider& operator=(BasicCompressedCachedFileProvider&&) = default;
+
+    std::optional<std::string> getString(const std::filesystem::path& filepath) const;
+
+    /// The amount of bytes occupied by the compressed files
+    [[nodiscard]] std::size_t getCompressedSize() const { return compressedSize_; }
+    /// The amount of bytes the cached files would occupy uncompressed
+    [[nodiscard]] std::size_t getUncompressedSize() const { return uncompressedSize_; }
+
+    [[nodiscard]] const FileProviderStats& getStats() const { return stats_; }
+    void resetStats() const { stats_.reset(); }
+
+private:
+    struct CacheEntry {
+        std::string data;
+        std::size_t size;
+        // Files that do not get smaller are stored as they are
+        bool compressed;
+    };
+
+    // Inserts the file at the front of the hot set and evicts the least recently used file if the set is full
+    std::string makeHot(const std::string& key, std::string source) const;
+
+    void rebuildHotIndex() {
+        hotIndex_.clear();
+        for (auto it = hotSet_.begin(); it != hotSet_.end(); ++it) {
+            hotIndex_.try_emplace(it->first, it);
+        }
+    }
+
+    std::size_t hotSetSize_;
+    mutable FileProviderStats stats_;
+    mutable StringMap<CacheEntry> cache_;
+    mutable StringMap<std::filesystem::file_time_type> missing_;
+    mutable std::list<std::pair<std::string, std::string>> hotSet_;
+    mutable StringMap<std::list<std::pair<std::string, std::string>>::iterator> hotIndex_;
+    mutable std::size_t compressedSize_ = 0;
+    mutable std::size_t uncompressedSize_ = 0;
+};
+
+using CompressedCachedFileProvider = BasicCompressedCachedFileProvider<>;
+
+template<TracingPolicy TRACING>
+std::optional<std::string> BasicCompressedCachedFileProvider<TRACING>::getString(
+    const std::filesystem::path& filepath) const {
+    std::string str = filepath.string();
+    if (const auto it = hotIndex_.find(str); it != hotIndex_.end()) {
+        TRACING::instant("cache hit", str);
+        stats_.cacheHits.add();
+        stats_.stringsReturned.add();
+        hotSet_.splice(hotSet_.begin(), hotSet_, it->second);
+        return it->second->second;
+    }
+
+    if (const auto it = cache_.find(str); it != cache_.end()) {
+        TRACING::instant("cache hit", str);
+        stats_.cacheHits.add();
+        const CacheEntry& entry = it->second;
+        // Files stored as they are are served from the cache entry, a hot copy would only store them twice
+        if (!entry.compressed) {
+            stats_.stringsReturned.add();
+            return entry.data;
+        }
+
+        typename TRACING::Scope scope("decompress", str);
+        std::optional<std::string> source = decompressLZ(entry.data, entry.size);
+        if (!source.has_value()) {
+            return std::nullopt;
+        }
+        stats_.stringsReturned.add();
+        return makeHot(str, std::move(*source));
+    }
+
+    std::optional<std::string> source = readWithNegativeCache<TRACING>(filepath, str, missing_, stats_);
+    if (!source.has_value()) {
+        return std::nullopt;
+    }
+
+    std::string compressed;
+    {
+        typename TRACING::Scope scope("compress", str);
+        compressed = compressLZ(*source);
+    }
+    CacheEntry entry = compressed.size() < source->size() ?
+        CacheEntry{std::move(compressed), source->size(), true} : CacheEntry{*source, source->size(), false};
+    entry.data.shrink_to_fit();
+    bool isCompressed = entry.compressed;
+
+    compressedSize_ += entry.data.size();
+    uncompressedSize_ += entry.size;
+    cache_.try_emplace(str, std::move(entry));
+
+    stats_.stringsReturned.add();
+    if (!isCompressed) {
+        return source;
+    }
+    return makeHot(str, std::move(*source));
+}
+
+template<TracingPolicy TRACING>
+std::string BasicCompressedCachedFileProvider<TRACING>::makeHot(const std::string& key, std::string source) const {
+    if (hotSetSize_ == 0) {
+        return source;
+    }
+
+    if (hotSet_.size() >= hotSetSize_) {
+        hotIndex_.erase(hotSet_.back().first);
+        hotSet_.pop_back();
+    }
+    hotSet_.emplace_front(key, std::move(source));
+    hotIndex_.try_emplace(key, hotSet_.begin());
+    return hotSet_.front().second;
+}
@@ -0,0 +1,141 @@
+// MIT License
+//
+// Copyright (c) 2026 Levin Tertilt
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+using ContentHash = std::uint64_t;
+
+/// A fast, non-cryptographic 64 bit hash of the given bytes
+inline ContentHash hashContent(std::string_view data) {
+    constexpr std::uint64_t MULTIPLIER = 0x9e3779b97f4a7c15ULL;
+
+    auto mix = [](std::uint64_t hash, std::uint64_t word) {
+        word *= 0xbf58476d1ce4e5b9ULL;
+        word ^= word >> 31;
+        hash ^= word;
+        return ((hash << 27) | (hash >> 37)) * MULTIPLIER;
+    };
+
+    std::uint64_t hash = data.size() * MULTIPLIER;
+    std::size_t pos = 0;
+    for (; pos + sizeof(std::uint64_t) <= data.size(); pos += sizeof(std::uint64_t)) {
+        std::uint64_t word;
+        std::memcpy(&word, data.data() + pos, sizeof(word));
+        hash = mix(hash, word);
+    }
+    if (pos < data.size()) {
+        std::uint64_t word = 0;
+        std::memcpy(&word, data.data() + pos, data.size() - pos);
+        hash = mix(hash, word);
+    }
+
+    // Finalizer of splitmix64
+    hash ^= hash >> 30;
+    hash *= 0xbf58476d1ce4e5b9ULL;
+    hash ^= hash >> 27;
+    hash *= 0x94d049bb133111ebULL;
+    hash ^= hash >> 31;
+    return hash;
+}
+
+/// File contents stored in a ContentStore, together with their hash
+struct StoredContent {
+    ContentHash hash;
+    std::string data;
+};
+
+/// Stores file contents addressed by their hash, so byte identical files are only kept in memory once. The store only
+/// holds weak references, the contents are released as soon as no cache entry refers to them anymore, and references to
+/// released contents are purged once they make up about half of the store. A store may be shared by providers on
+/// different threads, including copies of one provider, so all accesses are synchronized
+class ContentStore {
+public:
+    using Handle = std::shared_ptr<const StoredContent>;
+
+    /// Returns the stored instance of the given content, which is inserted if no identical content is stored yet
+    Handle insert(std::string content) {
+        ContentHash hash = hashContent(content);
+
+        std::scoped_lock lock(mutex_);
+        auto [begin, end] = contents_.equal_range(hash);
+        for (auto it = begin; it != end;) {
+            if (Handle stored = it->second.lock()) {
+                if (stored->data == content) {
+                    return stored;
+                }
+                ++it;
+            } else {
+                it = contents_.erase(it);
+            }
+        }
+
+        Handle stored = std::make_shared<const StoredContent>(StoredContent{hash, std::move(content)});
+        contents_.emplace(hash, stored);
+
+        // Released contents are otherwise only purged when the same hash is inserted again, so long-running processes
+        // that see many versions of their files would grow the store without bound. Purging when the size doubled
+        // keeps the cost constant per insertion
+        if (contents_.size() >= purgeThreshold_) {
+            std::erase_if(contents_, [](const auto& entry) { return entry.second.expired(); });
+            purgeThreshold_ = std::max(MIN_PURGE_THRESHOLD, 2 * contents_.size());
+        }
+        return stored;
+    }
+
+    /// The amount of distinct contents that are currently stored
+    [[nodiscard]] std::size_t getUniqueCount() const {
+        std::scoped_lock lock(mutex_);
+        std::size_t count = 0;
+        for (const auto& [hash, content] : contents_) {
+            count += content.expired() ? 0 : 1;
+        }
+        return count;
+    }
+
+    /// The amount of bytes occupied by the distinct contents
+    [[nodiscard]] std::size_t getStoredBytes() const {
+        std::scoped_lock lock(mutex_);
+        std::size_t bytes = 0;
+        for (const auto& [hash, content] : contents_) {
+            if (Handle stored = content.lock()) {
+                bytes += stored->data.size();
+            }
+        }
+        return bytes;
+    }
+
+private:
+    static constexpr std::size_t MIN_PURGE_THRESHOLD = 64;
+
+    mutable std::mutex mutex_;
+    std::size_t purgeThreshold_ = MIN_PURGE_THRESHOLD;
+    std::unordered_multimap<ContentHash, std::weak_ptr<const StoredContent>> contents_;
+};
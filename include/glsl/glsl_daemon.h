@@ -0,0 +1,315 @@
+// MIT License
+//
+// Copyright (c) 2026 Levin Tertilt
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "glsl_source_processor.h"
+
+#if !GLSL_SP_POSIX_IO
+#error "The preprocessing daemon requires POSIX sockets"
+#endif
+
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+
+// The protocol between glsl_sp_daemon and its clients. Every message consists of a one byte code, a four byte payload
+// length and the payload, all integers are in native byte order since both sides run on the same machine. Requests
+// carry a DaemonRequest as code, responses a DaemonStatus.
+//
+// Every connection starts with a Hello request, the daemon answers it with Ok if it speaks the same protocol version
+// and with Incompatible otherwise, after which it closes the connection. Both payloads are the same.
+//
+// Hello payload:     DAEMON_MAGIC (4 bytes), DAEMON_PROTOCOL_VERSION (4 bytes)
+// GetSource payload: source type (1 byte), name (rest of the payload)
+// Process payload:   name (string), definition count (4 bytes), definition names and values (strings)
+// Response payload:  the source, if the status is Ok
+//
+// Strings inside of payloads are prefixed with their four byte length
+
+enum class DaemonRequest : std::uint8_t {
+    GetSource = 1,
+    Process = 2,
+    Hello = 3
+};
+
+enum class DaemonStatus : std::uint8_t {
+    Ok = 0,
+    Failed = 1,
+    BadRequest = 2,
+    // The response would exceed DAEMON_MAX_PAYLOAD_SIZE
+    TooLarge = 3,
+    // The Hello request carried a different magic or protocol version
+    Incompatible = 4
+};
+
+constexpr std::uint32_t DAEMON_MAX_PAYLOAD_SIZE = 256 * 1024 * 1024;
+// "GLSP" in little endian
+constexpr std::uint32_t DAEMON_MAGIC = 0x50534c47;
+// Incremented on every incompatible change of the protocol
+constexpr std::uint32_t DAEMON_PROTOCOL_VERSION = 1;
+
+struct DaemonMessage {
+    std::uint8_t code;
+    std::string payload;
+};
+
+/// Builds the payload of a message
+class DaemonPayloadWriter {
+public:
+    void writeU8(std::uint8_t value) { payload_ += static_cast<char>(value); }
+    void writeU32(std::uint32_t value) { payload_.append(reinterpret_cast<const char*>(&value), sizeof(value)); }
+    void writeString(std::string_view value) {
+        writeU32(static_cast<std::uint32_t>(value.size()));
+        payload_ += value;
+    }
+    void writeRaw(std::string_view value) { payload_ += value; }
+
+    [[nodiscard]] std::string& getPayload() { return payload_; }
+
+private:
+    std::string payload_;
+};
+
+/// Reads the payload of a message. Every read fails once the payload has been exhausted
+class DaemonPayloadReader {
+public:
+    explicit DaemonPayloadReader(std::string_view payload) :
+        payload_(payload) {}
+
+    std::optional<std::uint8_t> readU8() {
+        if (payload_.empty()) {
+            return std::nullopt;
+        }
+        auto value = static_cast<std::uint8_t>(payload_.front());
+        payload_.remove_prefix(1);
+        return value;
+    }
+    std::optional<std::uint32_t> readU32() {
+        if (payload_.size() < sizeof(std::uint32_t)) {
+            return std::nullopt;
+        }
+        std::uint32_t value;
+        std::memcpy(&value, payload_.data(), sizeof(value));
+        payload_.remove_prefix(sizeof(value));
+        return value;
+    }
+    std::optional<std::string_view> readString() {
+        std::optional<std::uint32_t> size = readU32();
+        if (!size.has_value() || *size > payload_.size()) {
+            return std::nullopt;
+        }
+        std::string_view value = payload_.substr(0, *size);
+        payload_.remove_prefix(*size);
+        return value;
+    }
+    std::string_view readRest() { return std::exchange(payload_, {}); }
+
+private:
+    std::string_view payload_;
+};
+
+inline bool writeDaemonBytes(int fd, const char* data, std::size_t size) {
+#ifdef MSG_NOSIGNAL
+    constexpr int FLAGS = MSG_NOSIGNAL;
+#else
+    constexpr int FLAGS = 0;
+#endif
+    while (size > 0) {
+        ssize_t count = ::send(fd, data, size, FLAGS);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += count;
+        size -= static_cast<std::size_t>(count);
+    }
+    return true;
+}
+
+inline bool readDaemonBytes(int fd, char* data, std::size_t size) {
+    while (size > 0) {
+        ssize_t count = ::recv(fd, data, size, 0);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            return false;
+        }
+        data += count;
+        size -= static_cast<std::size_t>(count);
+    }
+    return true;
+}
+
+/// Writes a message, fails without writing anything if the payload exceeds DAEMON_MAX_PAYLOAD_SIZE, since the other
+/// side would drop the connection on reading it
+inline bool writeDaemonMessage(int fd, std::uint8_t code, std::string_view payload) {
+    if (payload.size() > DAEMON_MAX_PAYLOAD_SIZE) {
+        return false;
+    }
+    char header[1 + sizeof(std::uint32_t)];
+    auto size = static_cast<std::uint32_t>(payload.size());
+    header[0] = static_cast<char>(code);
+    std::memcpy(header + 1, &size, sizeof(size));
+    return writeDaemonBytes(fd, header, sizeof(header)) && writeDaemonBytes(fd, payload.data(), payload.size());
+}
+
+inline std::optional<DaemonMessage> readDaemonMessage(int fd) {
+    char header[1 + sizeof(std::uint32_t)];
+    if (!readDaemonBytes(fd, header, sizeof(header))) {
+        return std::nullopt;
+    }
+
+    std::uint32_t size;
+    std::memcpy(&size, header + 1, sizeof(size));
+    if (size > DAEMON_MAX_PAYLOAD_SIZE) {
+        return std::nullopt;
+    }
+
+    DaemonMessage message{static_cast<std::uint8_t>(header[0]), std::string(size, '\0')};
+    if (!readDaemonBytes(fd, message.payload.data(), size)) {
+        return std::nullopt;
+    }
+    return message;
+}
+
+/// A SourceProvider that requests the sources from a running glsl_sp_daemon, so short-lived processes benefit from
+/// the warm caches of the daemon. Additionally, whole shaders can be preprocessed by the daemon. Copies of a provider
+/// share the same connection, which must not be used by multiple threads at the same time
+class DaemonSourceProvider {
+public:
+    /// Connects to the daemon listening on the given socket, fails if the daemon speaks a different protocol version
+    static std::optional<DaemonSourceProvider> connect(const std::filesystem::path& socketPath,
+        LoggingImpl log = STDIOLogging::logAsError);
+
+    std::optional<std::string> getSource(SourceType type, std::string_view name) const {
+        DaemonPayloadWriter writer;
+        writer.writeU8(static_cast<std::uint8_t>(type));
+        writer.writeRaw(name);
+        return request(DaemonRequest::GetSource, writer.getPayload(), name);
+    }
+
+    /// Lets the daemon preprocess the shader with the given definitions
+    std::optional<std::string> process(std::string_view name,
+        const std::vector<std::pair<std::string, std::string>>& definitions) const {
+        DaemonPayloadWriter writer;
+        writer.writeString(name);
+        writer.writeU32(static_cast<std::uint32_t>(definitions.size()));
+        for (const auto& [definition, value] : definitions) {
+            writer.writeString(definition);
+            writer.writeString(value);
+        }
+        return request(DaemonRequest::Process, writer.getPayload(), name);
+    }
+
+private:
+    struct Connection {
+        int fd;
+
+        explicit Connection(int fd) :
+            fd(fd) {}
+        Connection(const Connection&) = delete;
+        Connection& operator=(const Connection&) = delete;
+        ~Connection() { ::close(fd); }
+    };
+
+    DaemonSourceProvider(std::shared_ptr<Connection> connection, LoggingImpl log) :
+        connection_(std::move(connection)),
+        log_(log) {}
+
+    std::optional<std::string> request(DaemonRequest code, std::string_view payload, std::string_view name) const {
+        if (payload.size() > DAEMON_MAX_PAYLOAD_SIZE) {
+            log_(std::format("Request to the preprocessing daemon is too large: {}", name));
+            return std::nullopt;
+        }
+        if (!writeDaemonMessage(connection_->fd, static_cast<std::uint8_t>(code), payload)) {
+            log_("Lost connection to the preprocessing daemon");
+            return std::nullopt;
+        }
+
+        std::optional<DaemonMessage> response = readDaemonMessage(connection_->fd);
+        if (!response.has_value()) {
+            log_("Lost connection to the preprocessing daemon");
+            return std::nullopt;
+        }
+        if (response->code == static_cast<std::uint8_t>(DaemonStatus::TooLarge)) {
+            log_(std::format("The preprocessing daemon result is too large to be sent: {}", name));
+            return std::nullopt;
+        }
+        if (response->code != static_cast<std::uint8_t>(DaemonStatus::Ok)) {
+            log_(std::format("The preprocessing daemon failed to provide: {}", name));
+            return std::nullopt;
+        }
+        return std::move(response->payload);
+    }
+
+    std::shared_ptr<Connection> connection_;
+    LoggingImpl log_;
+};
+
+inline std::optional<DaemonSourceProvider> DaemonSourceProvider::connect(const std::filesystem::path& socketPath,
+    LoggingImpl log) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::string path = socketPath.string();
+    if (path.size() >= sizeof(address.sun_path)) {
+        log(std::format("Socket path is too long: {}", path));
+        return std::nullopt;
+    }
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+#ifdef SOCK_CLOEXEC
+    int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+#else
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+#endif
+    if (fd < 0) {
+        log("Failed to create socket");
+        return std::nullopt;
+    }
+    if (::connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        ::close(fd);
+        log(std::format("Failed to connect to the preprocessing daemon at: {}", path));
+        return std::nullopt;
+    }
+    auto connection = std::make_shared<Connection>(fd);
+
+    DaemonPayloadWriter writer;
+    writer.writeU32(DAEMON_MAGIC);
+    writer.writeU32(DAEMON_PROTOCOL_VERSION);
+    std::optional<DaemonMessage> response;
+    if (writeDaemonMessage(fd, static_cast<std::uint8_t>(DaemonRequest::Hello), writer.getPayload())) {
+        response = readDaemonMessage(fd);
+    }
+    if (!response.has_value() || response->code != static_cast<std::uint8_t>(DaemonStatus::Ok)) {
+        log(std::format("The preprocessing daemon at {} speaks an incompatible protocol", path));
+        return std::nullopt;
+    }
+
+    return DaemonSourceProvider(std::move(connection), log);
+}
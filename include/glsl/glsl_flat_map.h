@@ -0,0 +1,538 @@
+// MIT License
+//
+// Copyright (c) 2026 Levin Tertilt
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+/// A fast hash of short strings like paths and identifiers, in the manner of wyhash. Unlike hashContent, which mixes
+/// every word in turn, it folds 16 bytes per 128 bit multiplication, but its values may change between versions and
+/// must not be stored
+inline std::uint64_t hashString(std::string_view text) {
+    constexpr std::uint64_t SECRET0 = 0xa0761d6478bd642fULL;
+    constexpr std::uint64_t SECRET1 = 0xe7037ed1a0b428dbULL;
+
+    // Multiplies to 128 bits and folds the halves
+    auto multiplyFold = [](std::uint64_t a, std::uint64_t b) {
+#ifdef __SIZEOF_INT128__
+        unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+        return static_cast<std::uint64_t>(product) ^ static_cast<std::uint64_t>(product >> 64);
+#else
+        std::uint64_t low = (a & 0xffffffff) * (b & 0xffffffff);
+        std::uint64_t middle0 = (a >> 32) * (b & 0xffffffff);
+        std::uint64_t middle1 = (a & 0xffffffff) * (b >> 32);
+        std::uint64_t high = (a >> 32) * (b >> 32);
+        std::uint64_t carry = ((low >> 32) + (middle0 & 0xffffffff) + (middle1 & 0xffffffff)) >> 32;
+        high += (middle0 >> 32) + (middle1 >> 32) + carry;
+        return (low + (middle0 << 32) + (middle1 << 32)) ^ high;
+#endif
+    };
+    auto read64 = [](const char* data) {
+        std::uint64_t word;
+        std::memcpy(&word, data, sizeof(word));
+        return word;
+    };
+    auto read32 = [](const char* data) {
+        std::uint32_t word;
+        std::memcpy(&word, data, sizeof(word));
+        return static_cast<std::uint64_t>(word);
+    };
+
+    const char* data = text.data();
+    std::size_t size = text.size();
+    std::uint64_t seed = SECRET0;
+    std::uint64_t a = 0;
+    std::uint64_t b = 0;
+    // Short strings are read with two overlapping loads instead of byte by byte
+    if (size >= 8 && size <= 16) {
+        a = read64(data);
+        b = read64(data + size - 8);
+    } else if (size >= 4 && size < 8) {
+        a = read32(data);
+        b = read32(data + size - 4);
+    } else if (size > 0 && size < 4) {
+        a = static_cast<std::uint64_t>(static_cast<unsigned char>(data[0])) << 16 |
+            static_cast<std::uint64_t>(static_cast<unsigned char>(data[size / 2])) << 8 |
+            static_cast<unsigned char>(data[size - 1]);
+    } else if (size > 16) {
+        std::size_t pos = 0;
+        for (; pos + 16 < size; pos += 16) {
+            seed = multiplyFold(read64(data + pos) ^ SECRET1, read64(data + pos + 8) ^ seed);
+        }
+        // The last 16 bytes, which may overlap the previous block
+        a = read64(data + size - 16);
+        b = read64(data + size - 8);
+    }
+    return multiplyFold(SECRET1 ^ size, multiplyFold(a ^ SECRET1, b ^ seed));
+}
+
+/// Transparent hash of strings, so maps keyed by std::string can be searched with a std::string_view or a string
+/// literal without constructing a key
+struct StringHash {
+    using is_transparent = void;
+
+    std::size_t operator()(std::string_view text) const { return static_cast<std::size_t>(hashString(text)); }
+};
+
+/// A hash map that stores its entries in a single array and resolves collisions by open addressing, so a lookup touches
+/// a few adjacent slots instead of following the node and bucket pointers of std::unordered_map. Every slot has a
+/// control byte that holds whether the slot is empty, erased or full and in the latter case 7 bits of the hash. The
+/// control bytes of 8 slots are compared at once as a single word, so almost all mismatches are rejected without
+/// comparing keys, and the map stays fast up to a load of 7/8. If HASH and EQUAL are transparent, like StringHash and
+/// std::equal_to<>, keys of other types can be looked up and inserted without constructing a KEY first.
+///
+/// Unlike std::unordered_map, insertions may move the entries and invalidate all iterators and references, erasing
+/// only invalidates the erased entry. The keys must not be modified through an iterator
+template<typename KEY, typename VALUE, typename HASH = std::hash<KEY>, typename EQUAL = std::equal_to<KEY>>
+class FlatHashMap {
+    static constexpr bool TRANSPARENT = requires {
+        typename HASH::is_transparent;
+        typename EQUAL::is_transparent;
+    };
+
+    // Keys of the type itself, or anything that can be hashed and compared with them if the map is transparent
+    template<typename K>
+    static constexpr bool IS_LOOKUP_KEY = TRANSPARENT || std::is_same_v<std::remove_cvref_t<K>, KEY>;
+
+public:
+    using key_type = KEY;
+    using mapped_type = VALUE;
+    using value_type = std::pair<KEY, VALUE>;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using hasher = HASH;
+    using key_equal = EQUAL;
+
+private:
+    template<bool CONST>
+    class Iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = FlatHashMap::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<CONST, const value_type*, value_type*>;
+        using reference = std::conditional_t<CONST, const value_type&, value_type&>;
+
+        Iterator() = default;
+        // Converts an iterator to a const_iterator
+        template<bool OTHER> requires (CONST && !OTHER)
+        Iterator(const Iterator<OTHER>& other) :
+            control_(other.control_),
+            end_(other.end_),
+            slot_(other.slot_) {}
+
+        reference operator*() const { return *slot_; }
+        pointer operator->() const { return slot_; }
+
+        Iterator& operator++() {
+            ++control_;
+            ++slot_;
+            skipUnused();
+            return *this;
+        }
+
+        Iterator operator++(int) {
+            Iterator previous = *this;
+            ++*this;
+            return previous;
+        }
+
+        friend bool operator==(const Iterator& a, const Iterator& b) { return a.control_ == b.control_; }
+
+    private:
+        friend class FlatHashMap;
+        template<bool>
+        friend class Iterator;
+
+        Iterator(const std::uint8_t* control, const std::uint8_t* end, pointer slot) :
+            control_(control),
+            end_(end),
+            slot_(slot) {}
+
+        void skipUnused() {
+            while (control_ != end_ && !isFull(*control_)) {
+                ++control_;
+                ++slot_;
+            }
+        }
+
+        const std::uint8_t* control_ = nullptr;
+        const std::uint8_t* end_ = nullptr;
+        pointer slot_ = nullptr;
+    };
+
+public:
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    FlatHashMap() = default;
+
+    FlatHashMap(const FlatHashMap& other) :
+        hash_(other.hash_),
+        equal_(other.equal_) {
+        if (other.size_ == 0) {
+            return;
+        }
+        allocate(other.capacity_);
+        for (std::size_t i = 0; i < capacity_; ++i) {
+            if (isFull(other.control_[i])) {
+                std::construct_at(slots_ + i, other.slots_[i]);
+            }
+        }
+        // Erased markers are copied as well, lookups would otherwise stop at them and miss the entries probed past them
+        std::memcpy(control_, other.control_, capacity_);
+        size_ = other.size_;
+        erased_ = other.erased_;
+    }
+
+    FlatHashMap(FlatHashMap&& other) noexcept :
+        hash_(std::move(other.hash_)),
+        equal_(std::move(other.equal_)),
+        control_(std::exchange(other.control_, nullptr)),
+        slots_(std::exchange(other.slots_, nullptr)),
+        capacity_(std::exchange(other.capacity_, 0)),
+        size_(std::exchange(other.size_, 0)),
+        erased_(std::exchange(other.erased_, 0)) {}
+
+    FlatHashMap& operator=(const FlatHashMap& other) {
+        if (this != &other) {
+            FlatHashMap copy(other);
+            swap(copy);
+        }
+        return *this;
+    }
+
+    FlatHashMap& operator=(FlatHashMap&& other) noexcept {
+        FlatHashMap moved(std::move(other));
+        swap(moved);
+        return *this;
+    }
+
+    ~FlatHashMap() {
+        destroy();
+        deallocate();
+    }
+
+    void swap(FlatHashMap& other) noexcept {
+        using std::swap;
+        swap(hash_, other.hash_);
+        swap(equal_, other.equal_);
+        swap(control_, other.control_);
+        swap(slots_, other.slots_);
+        swap(capacity_, other.capacity_);
+        swap(size_, other.size_);
+        swap(erased_, other.erased_);
+    }
+
+    [[nodiscard]] iterator begin() { return makeIterator<false>(0, true); }
+    [[nodiscard]] iterator end() { return makeIterator<false>(capacity_, false); }
+    [[nodiscard]] const_iterator begin() const { return makeIterator<true>(0, true); }
+    [[nodiscard]] const_iterator end() const { return makeIterator<true>(capacity_, false); }
+
+    [[nodiscard]] std::size_t size() const { return size_; }
+    [[nodiscard]] bool empty() const { return size_ == 0; }
+    /// The amount of slots, of which at most 7/8 are used before the map grows
+    [[nodiscard]] std::size_t capacity() const { return capacity_; }
+
+    template<typename K> requires IS_LOOKUP_KEY<K>
+    [[nodiscard]] iterator find(const K& key) { return makeIterator<false>(findIndex(key), false); }
+
+    template<typename K> requires IS_LOOKUP_KEY<K>
+    [[nodiscard]] const_iterator find(const K& key) const { return makeIterator<true>(findIndex(key), false); }
+
+    template<typename K> requires IS_LOOKUP_KEY<K>
+    [[nodiscard]] bool contains(const K& key) const { return findIndex(key) != capacity_; }
+
+    /// Inserts an entry with the value constructed from the arguments, unless the key is already present. The key is
+    /// only converted to KEY if it is inserted
+    template<typename K, typename... ARGS> requires IS_LOOKUP_KEY<K> && std::is_constructible_v<KEY, K&&>
+    std::pair<iterator, bool> try_emplace(K&& key, ARGS&&... args) {
+        std::size_t hash = mix(hash_(key));
+        std::uint8_t tag = toTag(hash);
+
+        // The first erased slot on the way is reused, unless the key turns up behind it
+        std::size_t target = capacity_;
+        if (capacity_ > 0) {
+            std::size_t mask = capacity_ / GROUP_SIZE - 1;
+            for (std::size_t group = (hash >> 7) & mask;; group = (group + 1) & mask) {
+                std::size_t first = group * GROUP_SIZE;
+                std::uint64_t controls = loadGroup(first);
+                for (std::uint64_t matches = matchByte(controls, tag); matches != 0; matches &= matches - 1) {
+                    std::size_t i = first + getFirstByte(matches);
+                    if (equal_(slots_[i].first, key)) {
+                        return {makeIterator<false>(i, false), false};
+                    }
+                }
+                if (std::uint64_t unused = ~controls & HIGH_BITS; unused != 0 && target == capacity_) {
+                    target = first + getFirstByte(unused);
+                }
+                if (matchByte(controls, EMPTY) != 0) {
+                    break;
+                }
+            }
+        }
+
+        if (target == capacity_ || (control_[target] == EMPTY && (size_ + erased_ + 1) * 8 > capacity_ * 7)) {
+            std::size_t capacity = getCapacityFor(size_ + 1);
+            // Rehashing in place would leave too few free slots if the map is mostly full
+            if (capacity == capacity_ && (size_ + 1) * 16 > capacity_ * 7) {
+                capacity *= 2;
+            }
+            rehash(capacity);
+            target = findFreeSlot(hash);
+        }
+
+        std::construct_at(slots_ + target, std::piecewise_construct, std::forward_as_tuple(std::forward<K>(key)),
+            std::forward_as_tuple(std::forward<ARGS>(args)...));
+        erased_ -= control_[target] == ERASED ? 1 : 0;
+        control_[target] = tag;
+        ++size_;
+        return {makeIterator<false>(target, false), true};
+    }
+
+    /// Inserts the entry or assigns the value to the present entry of the key
+    template<typename K, typename M> requires IS_LOOKUP_KEY<K> && std::is_constructible_v<KEY, K&&>
+    std::pair<iterator, bool> insert_or_assign(K&& key, M&& value) {
+        if (std::size_t index = findIndex(key); index != capacity_) {
+            slots_[index].second = std::forward<M>(value);
+            return {makeIterator<false>(index, false), false};
+        }
+        return try_emplace(std::forward<K>(key), std::forward<M>(value));
+    }
+
+    /// Erases the entry and returns the iterator to the following one
+    iterator erase(const_iterator position) {
+        std::size_t index = static_cast<std::size_t>(position.control_ - control_);
+        eraseAt(index);
+        return makeIterator<false>(index, true);
+    }
+    iterator erase(iterator position) { return erase(const_iterator(position)); }
+
+    template<typename K> requires IS_LOOKUP_KEY<K>
+    std::size_t erase(const K& key) {
+        std::size_t index = findIndex(key);
+        if (index == capacity_) {
+            return 0;
+        }
+        eraseAt(index);
+        return 1;
+    }
+
+    /// Erases all entries, but keeps the allocated slots
+    void clear() {
+        destroy();
+        if (capacity_ > 0) {
+            std::memset(control_, EMPTY, capacity_);
+        }
+        size_ = 0;
+        erased_ = 0;
+    }
+
+    /// Allocates enough slots for the amount of entries, so they can be inserted without rehashing
+    void reserve(std::size_t count) {
+        if (std::size_t capacity = getCapacityFor(count); capacity > capacity_) {
+            rehash(capacity);
+        }
+    }
+
+private:
+    static constexpr std::uint8_t EMPTY = 0;
+    static constexpr std::uint8_t ERASED = 1;
+    static constexpr std::uint8_t FULL = 0x80;
+    // Probing checks the control bytes of a group of slots at once
+    static constexpr std::size_t GROUP_SIZE = 8;
+    static constexpr std::size_t MIN_CAPACITY = GROUP_SIZE;
+    static constexpr std::uint64_t LOW_BITS = 0x0101010101010101ULL;
+    static constexpr std::uint64_t HIGH_BITS = 0x8080808080808080ULL;
+
+    static bool isFull(std::uint8_t control) { return (control & FULL) != 0; }
+    static std::uint8_t toTag(std::size_t hash) { return static_cast<std::uint8_t>(FULL | (hash & 0x7f)); }
+
+    // Spreads the hash over all bits, since hashes like std::hash of integers are the value itself. The low 7 bits are
+    // the tag in the control byte, the bits above select the group
+    static std::size_t mix(std::size_t hash) {
+        std::uint64_t mixed = static_cast<std::uint64_t>(hash) * 0x9e3779b97f4a7c15ULL;
+        return static_cast<std::size_t>(mixed ^ (mixed >> 32));
+    }
+
+    // The smallest power of two capacity that holds the amount of entries below the maximum load
+    static std::size_t getCapacityFor(std::size_t count) {
+        std::size_t capacity = MIN_CAPACITY;
+        while (count * 8 > capacity * 7) {
+            capacity *= 2;
+        }
+        return capacity;
+    }
+
+    // The control bytes of the group starting at the index, the first one in the lowest byte
+    std::uint64_t loadGroup(std::size_t index) const {
+        std::uint64_t controls;
+        std::memcpy(&controls, control_ + index, sizeof(controls));
+        if constexpr (std::endian::native == std::endian::big) {
+            controls = byteSwap(controls);
+        }
+        return controls;
+    }
+
+    static std::uint64_t byteSwap(std::uint64_t value) {
+        std::uint64_t swapped = 0;
+        for (std::size_t i = 0; i < sizeof(value); ++i) {
+            swapped = (swapped << 8) | ((value >> (i * 8)) & 0xff);
+        }
+        return swapped;
+    }
+
+    // Sets the high bit of the bytes of the group that equal the value. The borrow of a match may set the bit of the
+    // following byte as well, which only costs a key comparison, but never clears the bit of an actual match
+    static std::uint64_t matchByte(std::uint64_t controls, std::uint8_t value) {
+        std::uint64_t difference = controls ^ (LOW_BITS * value);
+        return (difference - LOW_BITS) & ~difference & HIGH_BITS;
+    }
+
+    // The position in the group of the lowest byte with its high bit set
+    static std::size_t getFirstByte(std::uint64_t bytes) {
+        return static_cast<std::size_t>(std::countr_zero(bytes)) / 8;
+    }
+
+    template<bool CONST>
+    Iterator<CONST> makeIterator(std::size_t index, bool skipUnused) const {
+        Iterator<CONST> it(control_ + index, control_ + capacity_, slots_ + index);
+        if (skipUnused) {
+            it.skipUnused();
+        }
+        return it;
+    }
+
+    // Returns the index of the key, or the capacity if it is not present
+    template<typename K>
+    std::size_t findIndex(const K& key) const {
+        if (size_ == 0) {
+            return capacity_;
+        }
+        std::size_t hash = mix(hash_(key));
+        std::uint8_t tag = toTag(hash);
+        std::size_t mask = capacity_ / GROUP_SIZE - 1;
+        // There is always an empty slot, the probing ends at the first group that has one
+        for (std::size_t group = (hash >> 7) & mask;; group = (group + 1) & mask) {
+            std::size_t first = group * GROUP_SIZE;
+            std::uint64_t controls = loadGroup(first);
+            for (std::uint64_t matches = matchByte(controls, tag); matches != 0; matches &= matches - 1) {
+                std::size_t i = first + getFirstByte(matches);
+                if (equal_(slots_[i].first, key)) {
+                    return i;
+                }
+            }
+            if (matchByte(controls, EMPTY) != 0) {
+                return capacity_;
+            }
+        }
+    }
+
+    // The first slot that is not full on the probe sequence of the hash
+    std::size_t findFreeSlot(std::size_t hash) const {
+        std::size_t mask = capacity_ / GROUP_SIZE - 1;
+        for (std::size_t group = (hash >> 7) & mask;; group = (group + 1) & mask) {
+            if (std::uint64_t unused = ~loadGroup(group * GROUP_SIZE) & HIGH_BITS; unused != 0) {
+                return group * GROUP_SIZE + getFirstByte(unused);
+            }
+        }
+    }
+
+    void eraseAt(std::size_t index) {
+        std::destroy_at(slots_ + index);
+        // Probing ends at a group with an empty slot anyway, so the slot only has to stay marked in full groups
+        if (matchByte(loadGroup(index - index % GROUP_SIZE), EMPTY) != 0) {
+            control_[index] = EMPTY;
+        } else {
+            control_[index] = ERASED;
+            ++erased_;
+        }
+        --size_;
+    }
+
+    // Moves all entries into new slots, which drops the erased ones
+    void rehash(std::size_t capacity) {
+        std::uint8_t* control = control_;
+        value_type* slots = slots_;
+        std::size_t oldCapacity = capacity_;
+
+        allocate(capacity);
+        for (std::size_t i = 0; i < oldCapacity; ++i) {
+            if (isFull(control[i])) {
+                std::size_t target = findFreeSlot(mix(hash_(slots[i].first)));
+                std::construct_at(slots_ + target, std::move(slots[i]));
+                control_[target] = control[i];
+                std::destroy_at(slots + i);
+            }
+        }
+        erased_ = 0;
+
+        delete[] control;
+        std::allocator<value_type>().deallocate(slots, oldCapacity);
+    }
+
+    void allocate(std::size_t capacity) {
+        control_ = new std::uint8_t[capacity];
+        std::memset(control_, EMPTY, capacity);
+        slots_ = std::allocator<value_type>().allocate(capacity);
+        capacity_ = capacity;
+    }
+
+    void destroy() {
+        for (std::size_t i = 0; i < capacity_ && size_ > 0; ++i) {
+            if (isFull(control_[i])) {
+                std::destroy_at(slots_ + i);
+            }
+        }
+    }
+
+    void deallocate() {
+        delete[] control_;
+        if (slots_ != nullptr) {
+            std::allocator<value_type>().deallocate(slots_, capacity_);
+        }
+    }
+
+    [[no_unique_address]] HASH hash_;
+    [[no_unique_address]] EQUAL equal_;
+    std::uint8_t* control_ = nullptr;
+    value_type* slots_ = nullptr;
+    std::size_t capacity_ = 0;
+    std::size_t size_ = 0;
+    // Slots of erased entries, which count towards the load since they do not end a probe sequence
+    std::size_t erased_ = 0;
+};
+
+/// A FlatHashMap keyed by strings, which can be looked up with std::string_view
+template<typename VALUE>
+using StringMap = FlatHashMap<std::string, VALUE, StringHash, std::equal_to<>>;
@@ -0,0 +1,126 @@
+// MIT License
+//
+// Copyright (c) 2026 Levin Tertilt
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <format>
+#include <ostream>
+#include <ranges>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/// What a single header contributed to the processed shaders. The own values only count the lines of the header
+/// itself, while the total values also contain all includes expanded through it
+struct HeaderContribution {
+    // Number of shaders the header was expanded into
+    std::uint64_t inclusions = 0;
+    // Number of shaders in which the header was expanded directly from the source file, not through another header
+    std::uint64_t directInclusions = 0;
+    std::uint64_t ownBytes = 0;
+    std::uint64_t totalBytes = 0;
+    std::chrono::nanoseconds ownTime{};
+    std::chrono::nanoseconds totalTime{};
+    // Number of other headers expanded through this header
+    std::uint64_t nestedIncludes = 0;
+
+    HeaderContribution& operator+=(const HeaderContribution& other) {
+        inclusions += other.inclusions;
+        directInclusions += other.directInclusions;
+        ownBytes += other.ownBytes;
+        totalBytes += other.totalBytes;
+        ownTime += other.ownTime;
+        totalTime += other.totalTime;
+        nestedIncludes += other.nestedIncludes;
+        return *this;
+    }
+};
+
+/// Attributes the output size and processing time of a corpus of shaders to the headers they include, to find the
+/// headers that blow up the shaders. Filled by GLSLSourceProcessor::getShaderSource and not synchronized, concurrent
+/// builds should use a report per thread and merge them afterward
+class IncludeReport {
+public:
+    void addShader(std::size_t bytes, std::chrono::nanoseconds time) {
+        ++shaderCount_;
+        shaderBytes_ += bytes;
+        shaderTime_ += time;
+    }
+
+    void addHeader(const std::string& name, const HeaderContribution& contribution) {
+        headers_[name] += contribution;
+    }
+
+    void merge(const IncludeReport& other) {
+        shaderCount_ += other.shaderCount_;
+        shaderBytes_ += other.shaderBytes_;
+        shaderTime_ += other.shaderTime_;
+        for (const auto& [name, contribution] : other.headers_) {
+            headers_[name] += contribution;
+        }
+    }
+
+    void clear() { *this = IncludeReport(); }
+
+    [[nodiscard]] std::uint64_t getShaderCount() const { return shaderCount_; }
+    [[nodiscard]] std::uint64_t getShaderBytes() const { return shaderBytes_; }
+    [[nodiscard]] std::chrono::nanoseconds getShaderTime() const { return shaderTime_; }
+    [[nodiscard]] const std::unordered_map<std::string, HeaderContribution>& getHeaders() const { return headers_; }
+
+    /// Returns the headers ordered by the total bytes they added to all shaders, largest first
+    [[nodiscard]] std::vector<std::pair<std::string, HeaderContribution>> getSortedHeaders() const {
+        std::vector<std::pair<std::string, HeaderContribution>> sorted(headers_.begin(), headers_.end());
+        std::ranges::sort(sorted, [](const auto& a, const auto& b) {
+            return a.second.totalBytes != b.second.totalBytes ? a.second.totalBytes > b.second.totalBytes :
+                a.first < b.first;
+        });
+        return sorted;
+    }
+
+    /// Writes the report as a table, limited to the given number of headers
+    void write(std::ostream& stream, std::size_t limit = SIZE_MAX) const {
+        stream << std::format("{} shaders, {} bytes, {:.3f} ms\n", shaderCount_, shaderBytes_, toMs(shaderTime_));
+        stream << std::format("{:>8} {:>8} {:>12} {:>7} {:>12} {:>10} {:>10} {:>7}  {}\n", "shaders", "direct",
+            "total bytes", "share", "own bytes", "total ms", "own ms", "nested", "header");
+
+        for (const auto& [name, header] : getSortedHeaders() | std::views::take(limit)) {
+            double share = shaderBytes_ == 0 ? 0.0 : 100.0 * static_cast<double>(header.totalBytes) /
+                static_cast<double>(shaderBytes_);
+            stream << std::format("{:>8} {:>8} {:>12} {:>6.1f}% {:>12} {:>10.3f} {:>10.3f} {:>7}  {}\n",
+                header.inclusions, header.directInclusions, header.totalBytes, share, header.ownBytes,
+                toMs(header.totalTime), toMs(header.ownTime), header.nestedIncludes, name);
+        }
+    }
+
+private:
+    static double toMs(std::chrono::nanoseconds time) {
+        return std::chrono::duration<double, std::milli>(time).count();
+    }
+
+    std::uint64_t shaderCount_ = 0;
+    std::uint64_t shaderBytes_ = 0;
+    std::chrono::nanoseconds shaderTime_{};
+    std::unordered_map<std::string, HeaderContribution> headers_;
+};
@@ -0,0 +1,191 @@
+// MIT License
+//
+// Copyright (c) 2026 Levin Tertilt
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// A small LZ77 codec using the LZ4 block layout. It trades compression ratio for speed, which fits shader sources well
+// since they are highly repetitive and have to be decompressed on every access.
+//
+// Every sequence starts with a token, whose high nibble holds the literal length and whose low nibble holds the match
+// length minus LZ_MIN_MATCH. A nibble value of 15 is followed by additional length bytes, which are added up until a
+// byte other than 255 is read. The literals follow the token, then a 2 byte little endian offset of the match. The last
+// sequence consists only of literals.
+
+constexpr std::size_t LZ_MIN_MATCH = 4;
+constexpr std::size_t LZ_MAX_OFFSET = 65535;
+constexpr unsigned LZ_HASH_BITS = 14;
+
+inline std::uint32_t readLZWord(const char* data) {
+    std::uint32_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+inline void writeLZLength(std::string& output, std::size_t length) {
+    while (length >= 255) {
+        output += static_cast<char>(255);
+        length -= 255;
+    }
+    output += static_cast<char>(length);
+}
+
+inline void writeLZSequence(std::string& output, std::string_view literals, std::size_t offset,
+    std::size_t matchLength) {
+    std::size_t literalLength = literals.size();
+    std::size_t extraMatch = matchLength >= LZ_MIN_MATCH ? matchLength - LZ_MIN_MATCH : 0;
+
+    output += static_cast<char>((std::min<std::size_t>(literalLength, 15) << 4) | std::min<std::size_t>(extraMatch,
+        15));
+    if (literalLength >= 15) {
+        writeLZLength(output, literalLength - 15);
+    }
+    output += literals;
+
+    if (matchLength == 0) {
+        return;
+    }
+    output += static_cast<char>(offset & 0xff);
+    output += static_cast<char>(offset >> 8);
+    if (extraMatch >= 15) {
+        writeLZLength(output, extraMatch - 15);
+    }
+}
+
+/// Compresses the input, the size of the input has to be stored separately in order to decompress it again
+inline std::string compressLZ(std::string_view input) {
+    std::string output;
+    output.reserve(input.size() / 2 + 16);
+
+    std::vector<std::uint32_t> table(std::size_t{1} << LZ_HASH_BITS, 0);
+    auto hash = [](std::uint32_t word) {
+        return (word * 2654435761u) >> (32 - LZ_HASH_BITS);
+    };
+
+    const char* data = input.data();
+    std::size_t literalStart = 0;
+    std::size_t pos = 0;
+
+    // Positions are stored incremented by one, so that zero marks an empty slot
+    while (input.size() >= LZ_MIN_MATCH && pos <= input.size() - LZ_MIN_MATCH) {
+        std::uint32_t word = readLZWord(data + pos);
+        std::uint32_t& slot = table[hash(word)];
+        std::size_t candidate = slot;
+        slot = static_cast<std::uint32_t>(pos + 1);
+
+        if (candidate == 0 || pos + 1 - candidate > LZ_MAX_OFFSET || readLZWord(data + candidate - 1) != word) {
+            ++pos;
+            continue;
+        }
+
+        std::size_t matchStart = candidate - 1;
+        std::size_t length = LZ_MIN_MATCH;
+        while (pos + length < input.size() && data[matchStart + length] == data[pos + length]) {
+            ++length;
+        }
+
+        writeLZSequence(output, input.substr(literalStart, pos - literalStart), pos - matchStart, length);
+        pos += length;
+        literalStart = pos;
+    }
+
+    writeLZSequence(output, input.substr(literalStart), 0, 0);
+    return output;
+}
+
+/// Decompresses data produced by compressLZ. Returns std::nullopt if the data is malformed
+inline std::optional<std::string> decompressLZ(std::string_view compressed, std::size_t decompressedSize) {
+    std::string output(decompressedSize, '\0');
+    char* out = output.data();
+    std::size_t outPos = 0;
+    std::size_t inPos = 0;
+
+    auto readLength = [&](std::size_t length) -> std::optional<std::size_t> {
+        if (length != 15) {
+            return length;
+        }
+        while (true) {
+            if (inPos >= compressed.size()) {
+                return std::nullopt;
+            }
+            auto byte = static_cast<unsigned char>(compressed[inPos++]);
+            length += byte;
+            if (byte != 255) {
+                return length;
+            }
+        }
+    };
+
+    while (inPos < compressed.size()) {
+        auto token = static_cast<unsigned char>(compressed[inPos++]);
+
+        std::optional<std::size_t> literalLength = readLength(token >> 4);
+        if (!literalLength || *literalLength > compressed.size() - inPos ||
+            *literalLength > decompressedSize - outPos) {
+            return std::nullopt;
+        }
+        std::memcpy(out + outPos, compressed.data() + inPos, *literalLength);
+        inPos += *literalLength;
+        outPos += *literalLength;
+
+        if (inPos == compressed.size()) {
+            break;
+        }
+        if (compressed.size() - inPos < 2) {
+            return std::nullopt;
+        }
+        std::size_t offset = static_cast<unsigned char>(compressed[inPos]) |
+            static_cast<std::size_t>(static_cast<unsigned char>(compressed[inPos + 1])) << 8;
+        inPos += 2;
+
+        std::optional<std::size_t> matchLength = readLength(token & 0xf);
+        if (!matchLength || offset == 0 || offset > outPos) {
+            return std::nullopt;
+        }
+        *matchLength += LZ_MIN_MATCH;
+        if (*matchLength > decompressedSize - outPos) {
+            return std::nullopt;
+        }
+
+        // The match may overlap with the bytes being written, so it is copied byte by byte in that case
+        const char* match = out + outPos - offset;
+        if (offset >= *matchLength) {
+            std::memcpy(out + outPos, match, *matchLength);
+        } else {
+            for (std::size_t i = 0; i < *matchLength; ++i) {
+                out[outPos + i] = match[i];
+            }
+        }
+        outPos += *matchLength;
+    }
+
+    if (outPos != decompressedSize) {
+        return std::nullopt;
+    }
+    return output;
+}
@@ -0,0 +1,357 @@
+// MIT License
+//
+// Copyright (c) 2026 Levin Tertilt
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "glsl_source_processor.h"
+
+#if !GLSL_SP_POSIX_IO
+#error "SharedMemoryFileProvider requires POSIX shared memory"
+#endif
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <new>
+#include <thread>
+
+#include <sys/mman.h>
+
+/// A FileProviderImpl whose cache lives in a POSIX shared memory segment, so that multiple processes working on the
+/// same shader tree only read and store each file once. One process creates the segment and populates it, others open
+/// it read-only and map the cached files. Files that are not in the segment are read from disk by read-only providers,
+/// without caching them. Like CachedFileProvider, cached files are never updated.
+///
+/// The segment consists of a header, an open addressing index and the data region. Slots are claimed with a
+/// compare-and-swap and published once their data is written, so lookups never block, even while another process is
+/// inserting files. Writers that race on the same file briefly wait for each other, so only one of them stores it.
+/// Copies of a provider share the same mapping
+class SharedMemoryFileProvider {
+public:
+    static constexpr std::size_t DEFAULT_DATA_CAPACITY = 64 * 1024 * 1024;
+    static constexpr std::uint32_t DEFAULT_SLOT_COUNT = 16384;
+
+    /// Creates the segment with the given name (which has to start with a slash), or opens an existing one for
+    /// writing. The capacities are ignored for existing segments
+    static std::optional<SharedMemoryFileProvider> create(const std::string& name,
+        std::size_t dataCapacity = DEFAULT_DATA_CAPACITY, std::uint32_t slotCount = DEFAULT_SLOT_COUNT,
+        LoggingImpl log = STDIOLogging::logAsError);
+
+    /// Opens an existing segment read-only
+    static std::optional<SharedMemoryFileProvider> open(const std::string& name,
+        LoggingImpl log = STDIOLogging::logAsError);
+
+    /// Removes the segment name from the system, the memory is released once all processes unmapped it
+    static void remove(const std::string& name) { ::shm_unlink(name.c_str()); }
+
+    std::optional<std::string> getString(const std::filesystem::path& filepath) const;
+
+    [[nodiscard]] bool isWritable() const { return mapping_->writable; }
+
+    /// The amount of bytes of the data region that are in use
+    [[nodiscard]] std::size_t getUsedBytes() const;
+
+private:
+    static constexpr std::uint64_t MAGIC = 0x474c534c53484d31ULL;
+    static constexpr std::uint32_t VERSION = 1;
+    // How often a writer yields while waiting for an earlier slot to be published, before it inserts anyway
+    static constexpr int MAX_WRITE_WAIT_SPINS = 4096;
+
+    enum SlotState : std::uint32_t {
+        SLOT_EMPTY = 0,
+        SLOT_WRITING = 1,
+        SLOT_READY = 2,
+        // Claimed by a writer that then did not publish, skipped like a filled slot
+        SLOT_ABANDONED = 3
+    };
+
+    struct SegmentHeader {
+        std::atomic<std::uint64_t> magic;
+        std::uint32_t version;
+        std::uint32_t slotCount;
+        std::uint64_t dataCapacity;
+        std::atomic<std::uint64_t> dataUsed;
+    };
+
+    struct Slot {
+        std::atomic<std::uint32_t> state;
+        std::uint32_t pathLength;
+        std::uint64_t hash;
+        std::uint64_t offset;
+        std::uint64_t size;
+    };
+
+    static_assert(std::atomic<std::uint64_t>::is_always_lock_free && std::atomic<std::uint32_t>::is_always_lock_free,
+        "Shared memory atomics have to be lock free");
+
+    struct Mapping {
+        void* address = nullptr;
+        std::size_t size = 0;
+        bool writable = false;
+
+        Mapping() = default;
+        Mapping(const Mapping&) = delete;
+        Mapping& operator=(const Mapping&) = delete;
+        ~Mapping() {
+            if (address != nullptr) {
+                ::munmap(address, size);
+            }
+        }
+    };
+
+    explicit SharedMemoryFileProvider(std::shared_ptr<Mapping> mapping) :
+        mapping_(std::move(mapping)) {}
+
+    static std::size_t getSegmentSize(std::uint32_t slotCount, std::uint64_t dataCapacity) {
+        return sizeof(SegmentHeader) + slotCount * sizeof(Slot) + dataCapacity;
+    }
+    // Maps an existing segment and verifies its header
+    static std::optional<SharedMemoryFileProvider> map(int fd, bool writable, LoggingImpl log);
+
+    [[nodiscard]] SegmentHeader& getHeader() const { return *static_cast<SegmentHeader*>(mapping_->address); }
+    [[nodiscard]] Slot* getSlots() const { return reinterpret_cast<Slot*>(&getHeader() + 1); }
+    [[nodiscard]] char* getData() const { return reinterpret_cast<char*>(getSlots() + getHeader().slotCount); }
+
+    // The file of a published slot, copied out of the segment before it is validated
+    struct SlotFile {
+        std::uint64_t hash;
+        std::uint64_t offset;
+        std::uint64_t pathLength;
+        std::uint64_t size;
+    };
+
+    // Slots are written by other processes, so a corrupt slot must not lead to reads outside of the data region. Slots
+    // that do not fit into it are treated like slots of other files
+    [[nodiscard]] std::optional<SlotFile> readSlot(const Slot& slot) const {
+        SlotFile file{slot.hash, slot.offset, slot.pathLength, slot.size};
+        std::uint64_t capacity = getHeader().dataCapacity;
+        if (file.offset > capacity || file.pathLength > capacity - file.offset ||
+            file.size > capacity - file.offset - file.pathLength) {
+            return std::nullopt;
+        }
+        return file;
+    }
+    [[nodiscard]] bool isFileOf(const SlotFile& file, std::uint64_t hash, std::string_view path) const {
+        return file.hash == hash && file.pathLength == path.size() &&
+            std::memcmp(getData() + file.offset, path.data(), path.size()) == 0;
+    }
+    void insert(std::uint64_t hash, std::string_view path, std::string_view source) const;
+
+    std::shared_ptr<Mapping> mapping_;
+};
+
+inline std::optional<SharedMemoryFileProvider> SharedMemoryFileProvider::create(const std::string& name,
+    std::size_t dataCapacity, std::uint32_t slotCount, LoggingImpl log) {
+    int fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+    if (fd < 0 && errno == EEXIST) {
+        fd = ::shm_open(name.c_str(), O_RDWR | O_CLOEXEC, 0600);
+        if (fd < 0) {
+            log(std::format("Failed to open shared memory segment: {}", name));
+            return std::nullopt;
+        }
+        auto provider = map(fd, true, log);
+        ::close(fd);
+        return provider;
+    }
+    if (fd < 0) {
+        log(std::format("Failed to create shared memory segment: {}", name));
+        return std::nullopt;
+    }
+
+    auto mapping = std::make_shared<Mapping>();
+    mapping->size = getSegmentSize(slotCount, dataCapacity);
+    mapping->writable = true;
+    if (::ftruncate(fd, static_cast<off_t>(mapping->size)) != 0) {
+        log(std::format("Failed to resize shared memory segment: {}", name));
+        ::close(fd);
+        ::shm_unlink(name.c_str());
+        return std::nullopt;
+    }
+
+    void* address = ::mmap(nullptr, mapping->size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (address == MAP_FAILED) {
+        log(std::format("Failed to map shared memory segment: {}", name));
+        ::shm_unlink(name.c_str());
+        return std::nullopt;
+    }
+    mapping->address = address;
+
+    // The segment is zero initialized by ftruncate, which already marks every slot as empty
+    auto* header = new (address) SegmentHeader{};
+    header->version = VERSION;
+    header->slotCount = slotCount;
+    header->dataCapacity = dataCapacity;
+    Slot* slots = reinterpret_cast<Slot*>(header + 1);
+    for (std::uint32_t i = 0; i < slotCount; ++i) {
+        new (&slots[i]) Slot{};
+    }
+    // Publishing the magic value marks the segment as initialized for other processes
+    header->magic.store(MAGIC, std::memory_order_release);
+
+    return SharedMemoryFileProvider(std::move(mapping));
+}
+
+inline std::optional<SharedMemoryFileProvider> SharedMemoryFileProvider::open(const std::string& name,
+    LoggingImpl log) {
+    int fd = ::shm_open(name.c_str(), O_RDONLY | O_CLOEXEC, 0);
+    if (fd < 0) {
+        log(std::format("Failed to open shared memory segment: {}", name));
+        return std::nullopt;
+    }
+    auto provider = map(fd, false, log);
+    ::close(fd);
+    return provider;
+}
+
+inline std::optional<SharedMemoryFileProvider> SharedMemoryFileProvider::map(int fd, bool writable, LoggingImpl log) {
+    constexpr auto INITIALIZATION_TIMEOUT = std::chrono::seconds(1);
+
+    // The creating process may still be initializing the segment
+    struct stat info {};
+    auto deadline = std::chrono::steady_clock::now() + INITIALIZATION_TIMEOUT;
+    while (::fstat(fd, &info) == 0 && static_cast<std::size_t>(info.st_size) < sizeof(SegmentHeader)) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            log("Shared memory segment has not been initialized");
+            return std::nullopt;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    auto mapping = std::make_shared<Mapping>();
+    mapping->size = static_cast<std::size_t>(info.st_size);
+    mapping->writable = writable;
+
+    void* address = ::mmap(nullptr, mapping->size, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+    if (address == MAP_FAILED) {
+        log("Failed to map shared memory segment");
+        return std::nullopt;
+    }
+    mapping->address = address;
+
+    const auto* header = static_cast<const SegmentHeader*>(address);
+    while (header->magic.load(std::memory_order_acquire) != MAGIC) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            log("Shared memory segment has not been initialized");
+            return std::nullopt;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    if (header->version != VERSION || header->dataCapacity > mapping->size ||
+        getSegmentSize(header->slotCount, header->dataCapacity) > mapping->size) {
+        log("Shared memory segment has an incompatible layout");
+        return std::nullopt;
+    }
+
+    return SharedMemoryFileProvider(std::move(mapping));
+}
+
+inline std::optional<std::string> SharedMemoryFileProvider::getString(const std::filesystem::path& filepath) const {
+    std::string str = filepath.string();
+    std::uint64_t hash = hashContent(str);
+
+    const SegmentHeader& header = getHeader();
+    const Slot* slots = getSlots();
+    const char* data = getData();
+
+    for (std::uint32_t probe = 0; probe < header.slotCount; ++probe) {
+        const Slot& slot = slots[(hash + probe) % header.slotCount];
+        std::uint32_t state = slot.state.load(std::memory_order_acquire);
+        if (state == SLOT_EMPTY) {
+            break;
+        }
+        // Slots that are still being written are skipped, the file is then read from disk instead
+        if (state != SLOT_READY) {
+            continue;
+        }
+        if (std::optional<SlotFile> file = readSlot(slot); file.has_value() && isFileOf(*file, hash, str)) {
+            return std::string(data + file->offset + file->pathLength, file->size);
+        }
+    }
+
+    std::optional<std::string> source = readString(filepath);
+    if (source.has_value() && isWritable()) {
+        insert(hash, str, *source);
+    }
+    return source;
+}
+
+inline void SharedMemoryFileProvider::insert(std::uint64_t hash, std::string_view path,
+    std::string_view source) const {
+    SegmentHeader& header = getHeader();
+    Slot* slots = getSlots();
+
+    std::uint64_t size = path.size() + source.size();
+    if (header.dataUsed.load(std::memory_order_relaxed) + size > header.dataCapacity) {
+        return;
+    }
+
+    // The slot is claimed before the data space, so a full index never leaves behind reserved but unused space
+    Slot* slot = nullptr;
+    std::uint32_t position = 0;
+    for (; position < header.slotCount; ++position) {
+        Slot& candidate = slots[(hash + position) % header.slotCount];
+        std::uint32_t expected = SLOT_EMPTY;
+        if (candidate.state.compare_exchange_strong(expected, SLOT_WRITING, std::memory_order_acquire)) {
+            slot = &candidate;
+            break;
+        }
+    }
+    if (slot == nullptr) {
+        return;
+    }
+
+    // Another writer may have claimed an earlier slot for the same file since the lookup. Earlier slots that are still
+    // being written are waited for, so of two racing writers only the one holding the earlier slot stores the file
+    for (std::uint32_t probe = 0; probe < position; ++probe) {
+        const Slot& other = slots[(hash + probe) % header.slotCount];
+        std::uint32_t state = other.state.load(std::memory_order_acquire);
+        for (int spin = 0; state == SLOT_WRITING && spin < MAX_WRITE_WAIT_SPINS; ++spin) {
+            std::this_thread::yield();
+            state = other.state.load(std::memory_order_acquire);
+        }
+        std::optional<SlotFile> file = state == SLOT_READY ? readSlot(other) : std::nullopt;
+        if (file.has_value() && isFileOf(*file, hash, path)) {
+            slot->state.store(SLOT_ABANDONED, std::memory_order_release);
+            return;
+        }
+    }
+
+    std::uint64_t offset = header.dataUsed.fetch_add(size, std::memory_order_relaxed);
+    if (offset + size > header.dataCapacity) {
+        slot->state.store(SLOT_ABANDONED, std::memory_order_release);
+        return;
+    }
+    std::memcpy(getData() + offset, path.data(), path.size());
+    std::memcpy(getData() + offset + path.size(), source.data(), source.size());
+
+    slot->pathLength = static_cast<std::uint32_t>(path.size());
+    slot->hash = hash;
+    slot->offset = offset;
+    slot->size = source.size();
+    slot->state.store(SLOT_READY, std::memory_order_release);
+}
+
+inline std::size_t SharedMemoryFileProvider::getUsedBytes() const {
+    const SegmentHeader& header = getHeader();
+    return std::min(header.dataUsed.load(std::memory_order_relaxed), header.dataCapacity);
+}
@@ -22,14 +22,28 @@
 
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <cstdint>
 #include <filesystem>
 #include <format>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
-#include <unordered_map>
-#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "glsl_content_store.h"
+#include "glsl_flat_map.h"
+#include "glsl_include_report.h"
+#include "glsl_stats.h"
+#include "glsl_thread_pool.h"
+#include "glsl_tracing.h"
 
-// TODO : Distinguish between cyclic inclusion (Error: A -> B -> A) and shared includes (Ok: A -> B, C, B -> C)
 // TODO : Also support <> brackets for including instead of solely quotation marks
 // TODO : Give the user the option to retrieve any faulty sources, in order to identify bugs that are generated after
 //  processing is applied
@@ -79,6 +93,9 @@ public:
         return srcRoot_ / name;
     }
 
+    [[nodiscard]] const std::filesystem::path& getSourceRoot() const { return srcRoot_; }
+    [[nodiscard]] const std::filesystem::path& getIncludeRoot() const { return includeRoot_; }
+
 private:
     std::filesystem::path srcRoot_;
     std::filesystem::path includeRoot_;
@@ -90,27 +107,63 @@ concept FileProviderImpl = requires(T t)
     { t.getString(std::declval<const std::filesystem::path&>()) } -> std::convertible_to<std::optional<std::string>>;
 };
 
-/// The default implementation of file provider. All files are loaded from disk for each request
-struct SillyFileProvider {
-    static std::optional<std::string> getString(const std::filesystem::path& filepath);
+/// The default implementation of file provider. All files are loaded from disk for each request. getString is not
+/// static, since the reads are counted in the statistics of the provider, use readString to read a file without one
+class SillyFileProvider {
+public:
+    std::optional<std::string> getString(const std::filesystem::path& filepath) const;
+
+    [[nodiscard]] const FileProviderStats& getStats() const { return stats_; }
+    void resetStats() const { stats_.reset(); }
+
+private:
+    mutable FileProviderStats stats_;
 };
 
 /// An implementation that caches files. This may be a good choice if the shader files never change at runtime. If
 /// you use mechanism to reload files at runtime, you should refrain from using this as the contents are not updated
-/// after they are in memory
-class CachedFileProvider {
+/// after they are in memory. Missing files are remembered as well and only looked up again once their parent
+/// directory has been modified. The contents are kept in a ContentStore, so byte identical files are stored only once,
+/// which may be shared with other providers. Cache hits and misses, as well as the file system accesses, are reported
+/// to the tracing policy
+template<TracingPolicy TRACING = NoTracing>
+class BasicCachedFileProvider {
 public:
+    explicit BasicCachedFileProvider(std::shared_ptr<ContentStore> store = std::make_shared<ContentStore>()) :
+        store_(std::move(store)) {}
+
     std::optional<std::string> getString(const std::filesystem::path& filepath) const;
 
+    /// Returns the hash of the cached contents of the file, without accessing the file system
+    [[nodiscard]] std::optional<ContentHash> getContentHash(const std::filesystem::path& filepath) const;
+
+    [[nodiscard]] const ContentStore& getContentStore() const { return *store_; }
+
+    [[nodiscard]] const FileProviderStats& getStats() const { return stats_; }
+    void resetStats() const { stats_.reset(); }
+
 private:
-    mutable std::unordered_map<std::string, std::string> cache_;
+    std::shared_ptr<ContentStore> store_;
+    mutable FileProviderStats stats_;
+    mutable StringMap<ContentStore::Handle> cache_;
+    // Files that could not be read, mapped to the write time of their parent directory at that point
+    mutable StringMap<std::filesystem::file_time_type> missing_;
 };
 
+using CachedFileProvider = BasicCachedFileProvider<>;
+
 /// An implementation that caches files, but additionally checks whether the resource has been modified, and if so
-/// refetch that file from the file system
-class SmartCachedFileProvider {
+/// refetch that file from the file system. By default every request checks the file metadata; wrap a large amount of
+/// requests in a batch to validate each file at most once per batch instead. Like CachedFileProvider, the contents are
+/// kept in a ContentStore
+template<TracingPolicy TRACING = NoTracing>
+class BasicSmartCachedFileProvider {
 public:
-    struct CacheKey {
+    explicit BasicSmartCachedFileProvider(std::shared_ptr<ContentStore> store = std::make_shared<ContentStore>()) :
+        store_(std::move(store)) {}
+
+    /// The key of the former cache, which is validated per batch epoch now. Kept for code that still names it
+    struct [[deprecated("The cache is no longer keyed by the file metadata")]] CacheKey {
         std::filesystem::path filepath;
         std::filesystem::file_time_type lastWrite;
         std::uintmax_t fileSize;
@@ -122,8 +175,9 @@ public:
 
         bool operator==(const CacheKey& rhs) const = default;
     };
-    struct CacheKeyHasher {
-        std::size_t operator()(const CacheKey& key) const noexcept {
+    struct [[deprecated("The cache is no longer keyed by the file metadata")]] CacheKeyHasher {
+        template<typename KEY>
+        std::size_t operator()(const KEY& key) const noexcept {
             std::size_t hash = 0;
 
             auto combineHash = [&hash](std::size_t v) {
@@ -139,10 +193,97 @@ public:
         }
     };
 
+    /// Scoped helper that keeps a batch open for its lifetime
+    class Batch {
+    public:
+        explicit Batch(const BasicSmartCachedFileProvider& provider) :
+            provider_(provider) { provider_.beginBatch(); }
+        ~Batch() { provider_.endBatch(); }
+
+        Batch(const Batch&) = delete;
+        Batch& operator=(const Batch&) = delete;
+
+    private:
+        const BasicSmartCachedFileProvider& provider_;
+    };
+
     std::optional<std::string> getString(const std::filesystem::path& filepath) const;
 
+    /// Returns the hash of the cached contents of the file as of its last validation, without accessing the file system
+    [[nodiscard]] std::optional<ContentHash> getContentHash(const std::filesystem::path& filepath) const;
+
+    [[nodiscard]] const ContentStore& getContentStore() const { return *store_; }
+
+    [[nodiscard]] const FileProviderStats& getStats() const { return stats_; }
+    void resetStats() const { stats_.reset(); }
+
+    /// Starts a batch. While a batch is active, files that were already validated in it are served from the cache
+    /// without touching the file system, so all requests of one batch see a consistent snapshot. Batches may be nested,
+    /// only the outermost one starts a new epoch
+    void beginBatch() const {
+        if (batchDepth_++ == 0) {
+            ++epoch_;
+        }
+    }
+    void endBatch() const { --batchDepth_; }
+
 private:
-    mutable std::unordered_map<CacheKey, std::string, CacheKeyHasher> cache_;
+    struct CacheEntry {
+        // Null if the file did not exist when it was last validated
+        ContentStore::Handle source;
+        // The write time of the file, or of its parent directory if the file is missing
+        std::filesystem::file_time_type lastWrite;
+        std::uintmax_t fileSize;
+        // The last epoch in which the metadata of this file was compared against the file system
+        std::uint64_t validatedEpoch;
+    };
+
+    std::shared_ptr<ContentStore> store_;
+    mutable FileProviderStats stats_;
+    mutable StringMap<CacheEntry> cache_;
+    mutable std::uint64_t epoch_ = 0;
+    mutable std::uint32_t batchDepth_ = 0;
+};
+
+using SmartCachedFileProvider = BasicSmartCachedFileProvider<>;
+
+/// Wraps another FileProviderImpl and serializes all requests to it, so a single (caching) provider can be shared by
+/// processors running on multiple threads
+template<FileProviderImpl IMPL>
+class SynchronizedFileProvider {
+public:
+    explicit SynchronizedFileProvider(IMPL impl = IMPL{}) :
+        impl_(std::move(impl)) {}
+    SynchronizedFileProvider(const SynchronizedFileProvider& other) :
+        impl_(other.getImplCopy()) {}
+    SynchronizedFileProvider(SynchronizedFileProvider&& other) noexcept :
+        impl_(std::move(other.impl_)) {}
+
+    std::optional<std::string> getString(const std::filesystem::path& filepath) const {
+        std::scoped_lock lock(mutex_);
+        return impl_.getString(filepath);
+    }
+
+    /// The statistics of the wrapped provider, which can be read without holding the lock
+    [[nodiscard]] const FileProviderStats& getStats() const requires requires(const IMPL& impl) { impl.getStats(); } {
+        return impl_.getStats();
+    }
+
+    /// Invokes the function with the wrapped provider while holding the lock
+    template<typename FUNCTION>
+    decltype(auto) withImpl(FUNCTION&& function) const {
+        std::scoped_lock lock(mutex_);
+        return std::forward<FUNCTION>(function)(impl_);
+    }
+
+private:
+    IMPL getImplCopy() const {
+        std::scoped_lock lock(mutex_);
+        return impl_;
+    }
+
+    IMPL impl_;
+    mutable std::mutex mutex_;
 };
 
 template<typename T>
@@ -153,7 +294,8 @@ concept SourceProvider = requires(T t)
 };
 
 /// An implementation of SourceProvider that reads the shader sources from the file system
-template<FileProviderImpl IMPL = SillyFileProvider, PathPolicy PATH_POLICY = SplitDirectories>
+template<FileProviderImpl IMPL = SillyFileProvider, PathPolicy PATH_POLICY = SplitDirectories, TracingPolicy TRACING =
+    NoTracing>
 class FileSourceProvider {
 public:
     explicit FileSourceProvider(IMPL impl = IMPL{}, PATH_POLICY policy = PATH_POLICY{}, LoggingImpl log =
@@ -163,6 +305,7 @@ public:
         log_(log) {}
 
     std::optional<std::string> getSource(SourceType type, std::string_view name) const {
+        typename TRACING::Scope scope("getSource", name);
         auto filepath = policy_.getFilepath(type, name);
         auto source = impl_.getString(filepath);
         if (!source.has_value()) {
@@ -171,21 +314,86 @@ public:
         return source;
     }
 
+    [[nodiscard]] const IMPL& getImpl() const { return impl_; }
+    [[nodiscard]] const PATH_POLICY& getPathPolicy() const { return policy_; }
+
 private:
     IMPL impl_;
     PATH_POLICY policy_;
     LoggingImpl log_;
 };
 
+/// A SourceProvider that shares ownership of another provider. Copies of this wrapper refer to the same underlying
+/// provider, so multiple processors can use one (warm) cache instead of each holding their own copy. Note that the
+/// wrapped provider is not synchronized, so sharing it across threads is only safe if the provider itself is
+template<SourceProvider SOURCE_PROVIDER>
+class SharedSourceProvider {
+public:
+    SharedSourceProvider() :
+        provider_(std::make_shared<SOURCE_PROVIDER>()) {}
+    explicit SharedSourceProvider(SOURCE_PROVIDER provider) :
+        provider_(std::make_shared<SOURCE_PROVIDER>(std::move(provider))) {}
+    explicit SharedSourceProvider(std::shared_ptr<SOURCE_PROVIDER> provider) :
+        provider_(std::move(provider)) {}
+
+    std::optional<std::string> getSource(SourceType type, std::string_view name) const {
+        return provider_->getSource(type, name);
+    }
+
+    [[nodiscard]] SOURCE_PROVIDER& get() const { return *provider_; }
+    [[nodiscard]] const std::shared_ptr<SOURCE_PROVIDER>& getShared() const { return provider_; }
+
+private:
+    std::shared_ptr<SOURCE_PROVIDER> provider_;
+};
+
+/// An implementation of SourceProvider that serves sources kept in memory, e.g. generated shaders or shaders embedded
+/// into the executable
+class MemorySourceProvider {
+public:
+    void addSource(SourceType type, std::string name, std::string source) {
+        getSources(type).insert_or_assign(std::move(name), std::move(source));
+    }
+    void removeSource(SourceType type, std::string_view name) {
+        if (auto it = getSources(type).find(name); it != getSources(type).end()) {
+            getSources(type).erase(it);
+        }
+    }
+    void clear() {
+        sources_.clear();
+        includes_.clear();
+    }
+
+    std::optional<std::string> getSource(SourceType type, std::string_view name) const {
+        const auto& sources = type == SourceType::Include ? includes_ : sources_;
+        if (auto it = sources.find(name); it != sources.end()) {
+            return it->second;
+        }
+        return std::nullopt;
+    }
+
+private:
+    std::map<std::string, std::string, std::less<>>& getSources(SourceType type) {
+        return type == SourceType::Include ? includes_ : sources_;
+    }
+
+    std::map<std::string, std::string, std::less<>> sources_;
+    std::map<std::string, std::string, std::less<>> includes_;
+};
+
 template<typename T>
 concept Stringable = requires(T t)
 {
     { std::to_string(t) } -> std::convertible_to<std::string>;
 };
 
-template<SourceProvider SOURCE_PROVIDER>
+/// Processes shader sources supplied by the source provider. The tracing policy records spans for every processed
+/// shader and include
+template<SourceProvider SOURCE_PROVIDER, TracingPolicy TRACING = NoTracing>
 class GLSLSourceProcessor {
 public:
+    static constexpr std::size_t DEFAULT_MAX_INCLUDE_DEPTH = 4096;
+
     explicit GLSLSourceProcessor(SOURCE_PROVIDER sourceProvider = SOURCE_PROVIDER{},
         std::string glslVersion = "#version 450 core", LoggingImpl log = STDIOLogging::logAsError) :
         sourceProvider_(std::move(sourceProvider)),
@@ -194,26 +402,114 @@ public:
 
     std::optional<std::string> getShaderSource(const std::string& name) const;
 
+    /// Like getShaderSource, but additionally stores the names of all included files in the order of their first
+    /// inclusion, e.g. to track the dependencies of the shader
+    std::optional<std::string> getShaderSource(const std::string& name, std::vector<std::string>& includedFiles) const;
+
+    /// Like getShaderSource, but additionally adds the size and processing time of the shader and of every included
+    /// header to the report
+    std::optional<std::string> getShaderSource(const std::string& name, IncludeReport& report) const;
+    std::optional<std::string> getShaderSource(const std::string& name, std::vector<std::string>& includedFiles,
+        IncludeReport& report) const;
+
     template<Stringable T>
     void define(std::string&& name, T&& value) {
         definitionMap_.insert_or_assign(std::move(name), std::to_string(std::forward<T>(value)));
     }
 
-    void define(std::string&& name) { definitionMap_.emplace(std::move(name), ""); }
-    void undef(const std::string& name) { definitionMap_.erase(name); }
+    // Defines the name with the value as it is, e.g. for values that are not numbers
+    void define(std::string&& name, std::string_view value) {
+        definitionMap_.insert_or_assign(std::move(name), std::string(value));
+    }
+
+    void define(std::string&& name) { definitionMap_.try_emplace(std::move(name)); }
+    void undef(std::string_view name) { definitionMap_.erase(name); }
     void undefAll() { definitionMap_.clear(); }
 
+    /// The defined names and values, in the order in which their directives are emitted
+    [[nodiscard]] const StringMap<std::string>& getDefinitions() const { return definitionMap_; }
+    [[nodiscard]] const SOURCE_PROVIDER& getSourceProvider() const { return sourceProvider_; }
+
+    [[nodiscard]] const ProcessorStats& getStats() const { return stats_; }
+    void resetStats() const { stats_.reset(); }
+
+    /// The maximum nesting depth of includes, deeper includes fail the shader. Includes are expanded without recursion,
+    /// so the limit only guards against runaway include chains, e.g. of generated files
+    void setMaxIncludeDepth(std::size_t depth) { maxIncludeDepth_ = depth; }
+    [[nodiscard]] std::size_t getMaxIncludeDepth() const { return maxIncludeDepth_; }
+
+    /// Reads the includes of every shader ahead of its expansion on the thread pool. The sibling includes of a file and
+    /// their nested includes are read and searched for further includes concurrently, then the shader is expanded from
+    /// the prefetched sources in the same order as without a pool, so the output and the included files stay the
+    /// same. Includes beyond the maximum depth are not read, but includes after a failing include are, so the provider
+    /// may log failures that the expansion stops before. Exceptions of the provider are rethrown on the calling thread
+    /// once all reads finished. The source provider has to support concurrent calls, like MemorySourceProvider,
+    /// SillyFileProvider or a SynchronizedFileProvider. A null pool reads the includes on the calling thread again
+    void setThreadPool(std::shared_ptr<ThreadPool> pool) { threadPool_ = std::move(pool); }
+    [[nodiscard]] const std::shared_ptr<ThreadPool>& getThreadPool() const { return threadPool_; }
+
 private:
-    template<SourceType TYPE>
-    std::optional<std::string> process(std::string_view source, std::unordered_set<std::string>&
-        alreadyIncludedFiles) const;
-    std::optional<std::string> getShaderInclude(const std::string& name, std::unordered_set<std::string>&
-        alreadyIncludedFiles) const;
+    // The sources of all includes reachable from a shader, read ahead of its expansion on the thread pool
+    struct Prefetch {
+        std::mutex mutex;
+        // Every include found so far, set once it has been read and empty if it could not be read
+        StringMap<std::optional<std::string>> sources;
+        // The includes that are still being read
+        std::atomic<std::size_t> pending = 0;
+        // The first exception thrown while reading
+        std::exception_ptr error;
+
+        void setError(std::exception_ptr exception) {
+            std::scoped_lock lock(mutex);
+            if (error == nullptr) {
+                error = std::move(exception);
+            }
+        }
+    };
+
+    // The state of a single getShaderSource call
+    struct ProcessState {
+        // Every include expanded so far, mapped to an id in the order of their first inclusion
+        StringMap<std::uint32_t> includeIds;
+        // Whether the include with the id is on the stack, i.e. currently being expanded
+        std::vector<bool> activeIncludes;
+        std::vector<std::string>* includedFiles = nullptr;
+        IncludeReport* report = nullptr;
+        Prefetch* prefetch = nullptr;
+    };
+
+    // A file whose lines are being expanded
+    struct IncludeFrame {
+        std::string name;
+        std::uint32_t id;
+        std::string source;
+        // The offset of the next line, beyond the end of the source once all lines are expanded
+        std::size_t position;
+        // The output size and time at the start of the include, and the totals of its nested includes, only used for
+        // the include report
+        std::size_t outputStart;
+        std::chrono::steady_clock::time_point start;
+        HeaderContribution nested;
+    };
+
+    std::optional<std::string> processShader(const std::string& name, ProcessState& state) const;
+    // Appends the expanded source to the result
+    bool expand(std::string source, ProcessState& state, std::string& result) const;
+    // Reads the includes of the source on the thread pool, which in turn read their own includes
+    // The depth is the nesting depth of the file the source belongs to, counting the shader itself
+    void prefetchIncludes(std::string_view source, std::size_t depth, Prefetch& prefetch) const;
+    void prefetchInclude(const std::string& name, std::size_t depth, Prefetch& prefetch) const;
+    std::optional<std::string> getInclude(const std::string& name, ProcessState& state) const;
+    void logCycle(const std::vector<IncludeFrame>& frames, std::uint32_t id, const std::string& name) const;
+    static void reportInclude(std::vector<IncludeFrame>& frames, ProcessState& state, const std::string& result);
 
     SOURCE_PROVIDER sourceProvider_;
     std::string glslVersion_;
     LoggingImpl log_;
-    std::unordered_map<std::string, std::string> definitionMap_;
+    StringMap<std::string> definitionMap_;
+    std::size_t maxIncludeDepth_ = DEFAULT_MAX_INCLUDE_DEPTH;
+    std::shared_ptr<ThreadPool> threadPool_;
+    mutable ProcessorStats stats_;
 };
 
 #include "glsl_source_processor.inl"
@@ -1,9 +1,26 @@
 #pragma once
 
+#include <algorithm>
 #include <format>
 #include <fstream>
 #include <iostream>
-#include <ranges>
+
+// Define GLSL_SP_NO_POSIX_IO to always read files through std::ifstream
+#if !defined(GLSL_SP_NO_POSIX_IO) && (defined(__unix__) || defined(__APPLE__))
+#define GLSL_SP_POSIX_IO 1
+
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#define GLSL_SP_POSIX_IO 0
+#endif
+
+// Files of at least this size are read with a sequential access hint
+#ifndef GLSL_SP_FADVISE_THRESHOLD
+#define GLSL_SP_FADVISE_THRESHOLD (256 * 1024)
+#endif
 
 constexpr std::string_view INCLUDE_PREFIX = "#include";
 
@@ -15,7 +32,7 @@ inline void STDIOLogging::logAsError(std::string_view msg) {
     std::cerr << "[GLSL] Error: " << msg << std::endl;
 }
 
-static std::optional<std::string> readString(const std::filesystem::path& filepath) {
+inline std::optional<std::string> readStringStream(const std::filesystem::path& filepath) {
     std::ifstream file(filepath, std::ios::binary | std::ios::ate);
     if (!file.is_open()) {
         return std::nullopt;
@@ -31,121 +48,567 @@ static std::optional<std::string> readString(const std::filesystem::path& filepa
     return buffer;
 }
 
-inline std::optional<std::string> SillyFileProvider::getString(const std::filesystem::path& filepath) {
-    return readString(filepath);
+#if GLSL_SP_POSIX_IO
+// Reads the file with a single open/fstat/pread sequence directly into the returned string, which avoids the stream
+// buffer allocation and the seeks of the iostream implementation
+inline std::optional<std::string> readStringPosix(const std::filesystem::path& filepath) {
+    int fd = ::open(filepath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return std::nullopt;
+    }
+
+    struct stat info {};
+    if (::fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+        ::close(fd);
+        return std::nullopt;
+    }
+
+#ifdef POSIX_FADV_SEQUENTIAL
+    // Not worth the additional syscall for the typical small shader file
+    if (info.st_size >= GLSL_SP_FADVISE_THRESHOLD) {
+        ::posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    }
+#endif
+
+    std::string buffer(static_cast<std::size_t>(info.st_size), '\0');
+    std::size_t offset = 0;
+    while (offset < buffer.size()) {
+        ssize_t count = ::pread(fd, buffer.data() + offset, buffer.size() - offset, static_cast<off_t>(offset));
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            ::close(fd);
+            return std::nullopt;
+        }
+        if (count == 0) {
+            // The file has been truncated in the meantime
+            buffer.resize(offset);
+            break;
+        }
+        offset += static_cast<std::size_t>(count);
+    }
+
+    ::close(fd);
+    return buffer;
+}
+#endif
+
+inline std::optional<std::string> readString(const std::filesystem::path& filepath,
+    FileProviderStats* stats = nullptr) {
+#if GLSL_SP_POSIX_IO
+    std::optional<std::string> source = readStringPosix(filepath);
+#else
+    std::optional<std::string> source = readStringStream(filepath);
+#endif
+
+    if (stats != nullptr) {
+        stats->openCalls.add();
+        if (source.has_value()) {
+            // The POSIX implementation queries the size with fstat
+            stats->statCalls.add(GLSL_SP_POSIX_IO);
+            stats->bytesRead.add(source->size());
+        }
+    }
+    return source;
+}
+
+inline std::optional<std::string> SillyFileProvider::getString(const std::filesystem::path& filepath) const {
+    std::optional<std::string> source = readString(filepath, &stats_);
+    stats_.stringsReturned.add(source.has_value());
+    return source;
+}
+
+// Returns the write time of the directory containing the file, or file_time_type::min() if it cannot be queried
+inline std::filesystem::file_time_type getDirectoryWriteTime(const std::filesystem::path& filepath,
+    FileProviderStats& stats) {
+    stats.statCalls.add();
+    std::error_code ec;
+    std::filesystem::file_time_type lastWrite = std::filesystem::last_write_time(filepath.parent_path(), ec);
+    return ec ? std::filesystem::file_time_type::min() : lastWrite;
+}
+
+// Reads a file that is not cached. Missing files are remembered with the write time of their directory and only read
+// again once it has been modified. The directory is only queried for files that are missing, after the failed read,
+// and the file is then read once more, so a file created in between still invalidates the negative entry
+template<TracingPolicy TRACING>
+std::optional<std::string> readWithNegativeCache(const std::filesystem::path& filepath, std::string& str,
+    StringMap<std::filesystem::file_time_type>& missing, FileProviderStats& stats) {
+    std::optional<std::filesystem::file_time_type> directoryWrite;
+    if (const auto it = missing.find(str); it != missing.end()) {
+        {
+            typename TRACING::Scope scope("stat", str);
+            directoryWrite = getDirectoryWriteTime(filepath, stats);
+        }
+        if (it->second == *directoryWrite) {
+            TRACING::instant("cache hit", str);
+            stats.cacheHits.add();
+            return std::nullopt;
+        }
+        missing.erase(it);
+    }
+
+    TRACING::instant("cache miss", str);
+    stats.cacheMisses.add();
+    std::optional<std::string> source;
+    {
+        typename TRACING::Scope scope("read", str);
+        source = readString(filepath, &stats);
+    }
+    if (!source.has_value() && !directoryWrite.has_value()) {
+        {
+            typename TRACING::Scope scope("stat", str);
+            directoryWrite = getDirectoryWriteTime(filepath, stats);
+        }
+        typename TRACING::Scope scope("read", str);
+        source = readString(filepath, &stats);
+    }
+    if (!source.has_value()) {
+        missing.try_emplace(std::move(str), *directoryWrite);
+    }
+    return source;
 }
 
-inline std::optional<std::string> CachedFileProvider::getString(const std::filesystem::path& filepath) const {
+template<TracingPolicy TRACING>
+std::optional<std::string> BasicCachedFileProvider<TRACING>::getString(const std::filesystem::path& filepath) const {
     std::string str = filepath.string();
     if (const auto it = cache_.find(str); it != cache_.end()) {
-        return it->second;
+        TRACING::instant("cache hit", str);
+        stats_.cacheHits.add();
+        stats_.stringsReturned.add();
+        return it->second->data;
     }
 
-    std::optional<std::string> source = readString(filepath);
+    std::optional<std::string> source = readWithNegativeCache<TRACING>(filepath, str, missing_, stats_);
     if (!source.has_value()) {
         return std::nullopt;
     }
 
-    return cache_.emplace(str, std::move(*source)).first->second;
+    stats_.stringsReturned.add();
+    return cache_.try_emplace(std::move(str), store_->insert(std::move(*source))).first->second->data;
 }
 
-inline std::optional<std::string> SmartCachedFileProvider::getString(const std::filesystem::path& filepath) const {
-    try {
-        CacheKey key(filepath);
-        if (const auto it = cache_.find(key); it != cache_.end()) {
-            return it->second;
+template<TracingPolicy TRACING>
+std::optional<ContentHash> BasicCachedFileProvider<TRACING>::getContentHash(
+    const std::filesystem::path& filepath) const {
+    if (const auto it = cache_.find(filepath.string()); it != cache_.end()) {
+        return it->second->hash;
+    }
+    return std::nullopt;
+}
+
+template<TracingPolicy TRACING>
+std::optional<std::string> BasicSmartCachedFileProvider<TRACING>::getString(
+    const std::filesystem::path& filepath) const {
+    auto toResult = [this](const ContentStore::Handle& source) -> std::optional<std::string> {
+        if (source == nullptr) {
+            return std::nullopt;
         }
+        stats_.stringsReturned.add();
+        return source->data;
+    };
+
+    std::string str = filepath.string();
+    auto it = cache_.find(str);
+    if (it != cache_.end() && batchDepth_ > 0 && it->second.validatedEpoch == epoch_) {
+        TRACING::instant("cache hit", str);
+        stats_.cacheHits.add();
+        return toResult(it->second.source);
+    }
 
-        std::optional<std::string> source = readString(filepath);
-        if (!source.has_value()) {
+    // Missing files are only checked again if their directory has been modified since
+    std::optional<std::filesystem::file_time_type> directoryWrite;
+    if (it != cache_.end() && it->second.source == nullptr) {
+        {
+            typename TRACING::Scope scope("stat", str);
+            directoryWrite = getDirectoryWriteTime(filepath, stats_);
+        }
+        if (it->second.lastWrite == *directoryWrite) {
+            TRACING::instant("cache hit", str);
+            stats_.cacheHits.add();
+            it->second.validatedEpoch = epoch_;
             return std::nullopt;
         }
+    }
 
-        return cache_.emplace(key, std::move(*source)).first->second;
-    } catch (std::filesystem::filesystem_error&) {
-        return std::nullopt;
+    std::error_code ec;
+    std::filesystem::file_time_type lastWrite;
+    std::uintmax_t fileSize;
+    auto statFile = [&] {
+        typename TRACING::Scope scope("stat", str);
+        lastWrite = std::filesystem::last_write_time(filepath, ec);
+        fileSize = ec ? 0 : std::filesystem::file_size(filepath, ec);
+        stats_.statCalls.add(lastWrite == std::filesystem::file_time_type::min() ? 1 : 2);
+    };
+    statFile();
+    // The directory is only queried for missing files, which are then checked once more, so a file created in between
+    // still invalidates the negative entry
+    if (ec && !directoryWrite.has_value()) {
+        {
+            typename TRACING::Scope scope("stat", str);
+            directoryWrite = getDirectoryWriteTime(filepath, stats_);
+        }
+        statFile();
     }
-}
 
-template<SourceProvider SOURCE_PROVIDER>
-std::optional<std::string> GLSLSourceProcessor<SOURCE_PROVIDER>::getShaderSource(const std::string& name) const {
-    std::optional<std::string> src = sourceProvider_.getSource(SourceType::Source, name);
-    if (src.has_value()) {
-        std::unordered_set<std::string> alreadyIncludedFiles;
-        return process<SourceType::Source>(src.value(), alreadyIncludedFiles);
+    std::optional<std::string> source;
+    if (!ec) {
+        if (it != cache_.end() && it->second.source != nullptr && it->second.lastWrite == lastWrite &&
+            it->second.fileSize == fileSize) {
+            TRACING::instant("cache hit", str);
+            stats_.cacheHits.add();
+            it->second.validatedEpoch = epoch_;
+            stats_.stringsReturned.add();
+            return it->second.source->data;
+        }
+
+        TRACING::instant("cache miss", str);
+        stats_.cacheMisses.add();
+        typename TRACING::Scope scope("read", str);
+        source = readString(filepath, &stats_);
     }
-    return src;
-}
 
-template<std::ranges::range R>
-auto getLine(R&& range) {
-    if constexpr (std::ranges::contiguous_range<R> && std::ranges::sized_range<R>) {
-        return std::string_view(std::ranges::data(range), std::ranges::size(range));
+    CacheEntry entry;
+    if (source.has_value()) {
+        entry = CacheEntry{store_->insert(std::move(*source)), lastWrite, fileSize, epoch_};
     } else {
-        return std::string(std::ranges::begin(range), std::ranges::end(range));
+        if (!directoryWrite.has_value()) {
+            // The file has been removed after it was checked
+            directoryWrite = getDirectoryWriteTime(filepath, stats_);
+        }
+        entry = CacheEntry{nullptr, *directoryWrite, 0, epoch_};
     }
+    return toResult(cache_.insert_or_assign(std::move(str), std::move(entry)).first->second.source);
 }
 
-template<SourceProvider SOURCE_PROVIDER>
-template<SourceType TYPE>
-std::optional<std::string> GLSLSourceProcessor<SOURCE_PROVIDER>::process(std::string_view source,
-    std::unordered_set<std::string>& alreadyIncludedFiles) const {
+template<TracingPolicy TRACING>
+std::optional<ContentHash> BasicSmartCachedFileProvider<TRACING>::getContentHash(
+    const std::filesystem::path& filepath) const {
+    if (const auto it = cache_.find(filepath.string()); it != cache_.end() && it->second.source != nullptr) {
+        return it->second.source->hash;
+    }
+    return std::nullopt;
+}
+
+template<SourceProvider SOURCE_PROVIDER, TracingPolicy TRACING>
+std::optional<std::string> GLSLSourceProcessor<SOURCE_PROVIDER, TRACING>::getShaderSource(
+    const std::string& name) const {
+    ProcessState state;
+    return processShader(name, state);
+}
+
+template<SourceProvider SOURCE_PROVIDER, TracingPolicy TRACING>
+std::optional<std::string> GLSLSourceProcessor<SOURCE_PROVIDER, TRACING>::getShaderSource(const std::string& name,
+    std::vector<std::string>& includedFiles) const {
+    ProcessState state;
+    state.includedFiles = &includedFiles;
+    return processShader(name, state);
+}
+
+template<SourceProvider SOURCE_PROVIDER, TracingPolicy TRACING>
+std::optional<std::string> GLSLSourceProcessor<SOURCE_PROVIDER, TRACING>::getShaderSource(const std::string& name,
+    IncludeReport& report) const {
+    ProcessState state;
+    state.report = &report;
+    return processShader(name, state);
+}
+
+template<SourceProvider SOURCE_PROVIDER, TracingPolicy TRACING>
+std::optional<std::string> GLSLSourceProcessor<SOURCE_PROVIDER, TRACING>::getShaderSource(const std::string& name,
+    std::vector<std::string>& includedFiles, IncludeReport& report) const {
+    ProcessState state;
+    state.includedFiles = &includedFiles;
+    state.report = &report;
+    return processShader(name, state);
+}
+
+template<SourceProvider SOURCE_PROVIDER, TracingPolicy TRACING>
+std::optional<std::string> GLSLSourceProcessor<SOURCE_PROVIDER, TRACING>::processShader(const std::string& name,
+    ProcessState& state) const {
+    typename TRACING::Scope scope("getShaderSource", name);
+    auto start = state.report != nullptr ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{};
+    std::optional<std::string> src = sourceProvider_.getSource(SourceType::Source, name);
+    if (!src.has_value()) {
+        return src;
+    }
+
     std::string result;
 
     // Rough estimate
-    result.reserve(source.size() + glslVersion_.size() + definitionMap_.size() * 32);
+    result.reserve(src->size() + glslVersion_.size() + definitionMap_.size() * 32);
+
+    result += glslVersion_;
+    result += '\n';
 
-    if constexpr (TYPE == SourceType::Source) {
-        result += glslVersion_;
+    for (const auto& [definition, value] : definitionMap_) {
+        constexpr std::string_view DEFINE_PREFIX = "#define ";
+        result += DEFINE_PREFIX;
+        result += definition;
+        result += ' ';
+        result += value;
         result += '\n';
+    }
 
-        for (const auto& [name, value] : definitionMap_) {
-            constexpr std::string_view DEFINE_PREFIX = "#define ";
-            result += DEFINE_PREFIX;
-            result += name;
-            result += ' ';
-            result += value;
-            result += '\n';
+    Prefetch prefetch;
+    if (threadPool_ != nullptr) {
+        try {
+            prefetchIncludes(*src, 1, prefetch);
+        } catch (...) {
+            prefetch.setError(std::current_exception());
         }
+        // Waits even after an error, since the submitted reads refer to the prefetch
+        threadPool_->helpUntil([&prefetch] { return prefetch.pending == 0; });
+        if (prefetch.error != nullptr) {
+            std::rethrow_exception(prefetch.error);
+        }
+        state.prefetch = &prefetch;
     }
 
-    for (auto range : std::ranges::split_view(source, '\n')) {
-        if (auto line = getLine(range); line.starts_with(INCLUDE_PREFIX)) {
-            size_t start = line.find('\"');
-            size_t end = line.rfind('\"');
+    if (!expand(std::move(src.value()), state, result)) {
+        return std::nullopt;
+    }
 
-            if (start == std::string::npos || end <= start) {
-                log_(std::format("Invalid include directive: {}", line));
-                return std::nullopt;
-            }
+    stats_.shadersProcessed.add();
+    stats_.bytesEmitted.add(result.size());
+    stats_.peakOutputSize.updateMax(result.size());
+    if (state.report != nullptr) {
+        state.report->addShader(result.size(), std::chrono::steady_clock::now() - start);
+    }
+    return std::make_optional(std::move(result));
+}
 
-            std::string includeName(line.substr(start + 1, end - start - 1));
-            if (alreadyIncludedFiles.contains(includeName))
-                continue;
+// Returns the offset of the first line of the text. Like split_view, an empty text has no lines at all
+inline std::size_t getFirstLine(std::string_view text) {
+    return text.empty() ? 1 : 0;
+}
+
+// Returns the offset of the next line at or after the position that starts with an include directive, or npos. The
+// prefix is searched in bulk, so text without directives is skipped without looking at its lines
+inline std::size_t findIncludeDirective(std::string_view text, std::size_t position) {
+    for (std::size_t found = text.find(INCLUDE_PREFIX, position); found != std::string_view::npos;
+        found = text.find(INCLUDE_PREFIX, found + 1)) {
+        if (found == 0 || text[found - 1] == '\n') {
+            return found;
+        }
+    }
+    return std::string_view::npos;
+}
+
+// Returns the name between the first and the last quote of an include directive, or nullopt if it has none
+inline std::optional<std::string_view> getIncludeName(std::string_view line) {
+    std::size_t start = line.find('\"');
+    std::size_t last = line.rfind('\"');
+    if (start == std::string_view::npos || last <= start) {
+        return std::nullopt;
+    }
+    return line.substr(start + 1, last - start - 1);
+}
+
+template<SourceProvider SOURCE_PROVIDER, TracingPolicy TRACING>
+bool GLSLSourceProcessor<SOURCE_PROVIDER, TRACING>::expand(std::string source, ProcessState& state,
+    std::string& result) const {
+    // The shader source and the includes being expanded. Every frame owns the contents of its file and the offset of
+    // its next line, so the depth of the includes does not grow the call stack
+    std::size_t firstLine = getFirstLine(source);
+    IncludeFrame root{"", 0, std::move(source), firstLine, 0, {}, {}};
+    std::vector<IncludeFrame> frames;
+
+    // The spans of the includes on the stack, kept in a list since the scopes refer to the names
+    struct TracedInclude {
+        std::string name;
+        typename TRACING::Scope scope;
 
-            alreadyIncludedFiles.insert(includeName);
+        explicit TracedInclude(std::string includeName) :
+            name(std::move(includeName)),
+            scope("getShaderInclude", name) {}
+    };
+    std::list<TracedInclude> tracedIncludes;
 
-            std::optional<std::string> include = getShaderInclude(includeName, alreadyIncludedFiles);
-            if (!include.has_value()) {
-                return std::nullopt;
+    while (true) {
+        IncludeFrame& frame = frames.empty() ? root : frames.back();
+        if (frame.position > frame.source.size()) {
+            if (frames.empty()) {
+                return true;
             }
+            if (state.report != nullptr) {
+                reportInclude(frames, state, result);
+            }
+            if constexpr (TRACING::ENABLED) {
+                tracedIncludes.pop_back();
+            }
+            state.activeIncludes[frame.id] = false;
+            frames.pop_back();
+            continue;
+        }
 
-            result += include.value();
-        } else {
-            result += line;
+        std::string_view text = frame.source;
+        std::size_t directive = findIncludeDirective(text, frame.position);
+        if (directive == std::string_view::npos) {
+            // Every line is followed by a line break, including the last one
+            result += text.substr(frame.position);
             result += '\n';
+            frame.position = text.size() + 1;
+            continue;
+        }
+
+        // The lines before the directive are copied as a whole, together with their line breaks
+        result += text.substr(frame.position, directive - frame.position);
+        std::size_t lineEnd = std::min(text.find('\n', directive), text.size());
+        std::string_view line = text.substr(directive, lineEnd - directive);
+        frame.position = lineEnd + 1;
+
+        std::optional<std::string_view> name = getIncludeName(line);
+        if (!name.has_value()) {
+            log_(std::format("Invalid include directive: {}", line));
+            return false;
         }
+
+        // The name is only copied out of the source if the include is seen for the first time
+        auto [entry, inserted] = state.includeIds.try_emplace(*name,
+            static_cast<std::uint32_t>(state.includeIds.size()));
+        if (!inserted) {
+            // Shared includes are only expanded once, but an include on the stack includes itself
+            if (state.activeIncludes[entry->second]) {
+                logCycle(frames, entry->second, entry->first);
+                return false;
+            }
+            continue;
+        }
+        std::uint32_t includeId = entry->second;
+        std::string includeName = entry->first;
+
+        stats_.includeExpansions.add();
+        if (state.includedFiles != nullptr) {
+            state.includedFiles->push_back(includeName);
+        }
+
+        if (frames.size() >= maxIncludeDepth_) {
+            log_(std::format("Exceeded the maximum include depth of {} at: {}", maxIncludeDepth_, includeName));
+            return false;
+        }
+
+        if constexpr (TRACING::ENABLED) {
+            tracedIncludes.emplace_back(includeName);
+        }
+        auto includeStart = state.report != nullptr ? std::chrono::steady_clock::now() :
+            std::chrono::steady_clock::time_point{};
+        std::optional<std::string> include = getInclude(includeName, state);
+        if (!include.has_value()) {
+            return false;
+        }
+
+        // Invalidates frame and line
+        firstLine = getFirstLine(include.value());
+        state.activeIncludes.push_back(true);
+        frames.push_back({std::move(includeName), includeId, std::move(include.value()), firstLine, result.size(),
+            includeStart, {}});
     }
+}
 
-    return std::make_optional(std::move(result));
+template<SourceProvider SOURCE_PROVIDER, TracingPolicy TRACING>
+void GLSLSourceProcessor<SOURCE_PROVIDER, TRACING>::prefetchIncludes(std::string_view source, std::size_t depth,
+    Prefetch& prefetch) const {
+    // The depth is the one of the includes found in the source, includes deeper than the maximum fail the expansion,
+    // so they are not read
+    if (depth > maxIncludeDepth_) {
+        return;
+    }
+    for (std::size_t directive = findIncludeDirective(source, 0); directive != std::string_view::npos;) {
+        std::size_t lineEnd = std::min(source.find('\n', directive), source.size());
+        std::optional<std::string_view> name = getIncludeName(source.substr(directive, lineEnd - directive));
+        directive = findIncludeDirective(source, lineEnd);
+
+        // Invalid directives fail the expansion later on
+        if (!name.has_value()) {
+            continue;
+        }
+        {
+            std::scoped_lock lock(prefetch.mutex);
+            if (!prefetch.sources.try_emplace(*name).second) {
+                continue;
+            }
+        }
+        ++prefetch.pending;
+        try {
+            threadPool_->submit([this, &prefetch, depth, includeName = std::string(*name)] {
+                prefetchInclude(includeName, depth + 1, prefetch);
+            });
+        } catch (...) {
+            --prefetch.pending;
+            throw;
+        }
+    }
+}
+
+template<SourceProvider SOURCE_PROVIDER, TracingPolicy TRACING>
+void GLSLSourceProcessor<SOURCE_PROVIDER, TRACING>::prefetchInclude(const std::string& name, std::size_t depth,
+    Prefetch& prefetch) const {
+    // Only decrements after the nested includes are pending, so the count does not drop to zero early, and on every
+    // exit, so a failed read does not leave the caller waiting
+    struct PendingGuard {
+        std::atomic<std::size_t>& pending;
+        ~PendingGuard() { --pending; }
+    } guard{prefetch.pending};
+
+    try {
+        std::optional<std::string> source = sourceProvider_.getSource(SourceType::Include, name);
+        if (source.has_value()) {
+            prefetchIncludes(*source, depth, prefetch);
+        }
+        std::scoped_lock lock(prefetch.mutex);
+        prefetch.sources.find(name)->second = std::move(source);
+    } catch (...) {
+        // Exceptions would terminate the workers, the caller rethrows them instead
+        prefetch.setError(std::current_exception());
+    }
 }
 
-template<SourceProvider SOURCE_PROVIDER>
-std::optional<std::string> GLSLSourceProcessor<SOURCE_PROVIDER>::getShaderInclude(const std::string& name,
-    std::unordered_set<std::string>& alreadyIncludedFiles) const {
-    std::optional<std::string> src = sourceProvider_.getSource(SourceType::Include, name);
-    if (src.has_value()) {
-        return process<SourceType::Include>(src.value(), alreadyIncludedFiles);
+template<SourceProvider SOURCE_PROVIDER, TracingPolicy TRACING>
+std::optional<std::string> GLSLSourceProcessor<SOURCE_PROVIDER, TRACING>::getInclude(const std::string& name,
+    ProcessState& state) const {
+    if (state.prefetch != nullptr) {
+        if (auto it = state.prefetch->sources.find(name); it != state.prefetch->sources.end()) {
+            // Every include is expanded at most once, so the source can be moved out
+            return std::move(it->second);
+        }
+    }
+    return sourceProvider_.getSource(SourceType::Include, name);
+}
+
+template<SourceProvider SOURCE_PROVIDER, TracingPolicy TRACING>
+void GLSLSourceProcessor<SOURCE_PROVIDER, TRACING>::logCycle(const std::vector<IncludeFrame>& frames,
+    std::uint32_t id, const std::string& name) const {
+    std::string path;
+    auto cycleStart = std::ranges::find(frames, id, &IncludeFrame::id);
+    for (auto it = cycleStart; it != frames.end(); ++it) {
+        path += it->name;
+        path += " -> ";
+    }
+    path += name;
+    log_(std::format("Cyclic include: {}", path));
+}
+
+template<SourceProvider SOURCE_PROVIDER, TracingPolicy TRACING>
+void GLSLSourceProcessor<SOURCE_PROVIDER, TRACING>::reportInclude(std::vector<IncludeFrame>& frames,
+    ProcessState& state, const std::string& result) {
+    const IncludeFrame& frame = frames.back();
+    // Includes of the shader source itself have no parent
+    HeaderContribution* parent = frames.size() > 1 ? &frames[frames.size() - 2].nested : nullptr;
+    std::size_t size = result.size() - frame.outputStart;
+    std::chrono::nanoseconds time = std::chrono::steady_clock::now() - frame.start;
+
+    state.report->addHeader(frame.name, HeaderContribution{
+        .inclusions = 1,
+        .directInclusions = parent == nullptr ? 1u : 0u,
+        .ownBytes = size - frame.nested.totalBytes,
+        .totalBytes = size,
+        .ownTime = time - frame.nested.totalTime,
+        .totalTime = time,
+        .nestedIncludes = frame.nested.nestedIncludes,
+    });
+    if (parent != nullptr) {
+        parent->totalBytes += size;
+        parent->totalTime += time;
+        parent->nestedIncludes += 1 + frame.nested.nestedIncludes;
     }
-    return src;
 }
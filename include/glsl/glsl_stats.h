@@ -0,0 +1,92 @@
+// MIT License
+//
+// Copyright (c) 2026 Levin Tertilt
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+/// A counter that may be updated and read concurrently. All accesses are relaxed, since the counters are only gathered
+/// for monitoring and do not synchronize anything
+class StatCounter {
+public:
+    StatCounter() = default;
+    StatCounter(const StatCounter& other) :
+        value_(other.load()) {}
+    StatCounter& operator=(const StatCounter& other) {
+        value_.store(other.load(), std::memory_order_relaxed);
+        return *this;
+    }
+
+    void add(std::uint64_t amount = 1) { value_.fetch_add(amount, std::memory_order_relaxed); }
+
+    /// Raises the counter to the value, if it is larger
+    void updateMax(std::uint64_t value) {
+        std::uint64_t current = load();
+        while (current < value && !value_.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+    }
+
+    [[nodiscard]] std::uint64_t load() const { return value_.load(std::memory_order_relaxed); }
+    void reset() { value_.store(0, std::memory_order_relaxed); }
+
+private:
+    std::atomic<std::uint64_t> value_ = 0;
+};
+
+/// Statistics of the file providers
+struct FileProviderStats {
+    StatCounter cacheHits;
+    StatCounter cacheMisses;
+    // Bytes read from disk
+    StatCounter bytesRead;
+    // Metadata queries of files and directories
+    StatCounter statCalls;
+    StatCounter openCalls;
+    // File contents handed out to the caller, every one of them is a separate string
+    StatCounter stringsReturned;
+
+    void reset() {
+        cacheHits.reset();
+        cacheMisses.reset();
+        bytesRead.reset();
+        statCalls.reset();
+        openCalls.reset();
+        stringsReturned.reset();
+    }
+};
+
+/// Statistics of GLSLSourceProcessor
+struct ProcessorStats {
+    StatCounter shadersProcessed;
+    StatCounter includeExpansions;
+    // The total size of all generated shader sources
+    StatCounter bytesEmitted;
+    // The size of the largest generated shader source
+    StatCounter peakOutputSize;
+
+    void reset() {
+        shadersProcessed.reset();
+        includeExpansions.reset();
+        bytesEmitted.reset();
+        peakOutputSize.reset();
+    }
+};
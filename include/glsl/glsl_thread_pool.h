@@ -0,0 +1,110 @@
+// MIT License
+//
+// Copyright (c) 2026 Levin Tertilt
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// A fixed set of worker threads that run submitted tasks in the order of their submission. A thread waiting for tasks
+/// to finish may run queued tasks itself with helpUntil, so tasks can wait for the tasks they submitted, and a pool
+/// can be shared by callers that run on its own workers, without tying up the workers
+class ThreadPool {
+public:
+    explicit ThreadPool(unsigned threadCount = std::max(1u, std::thread::hardware_concurrency())) {
+        for (unsigned i = 0; i < threadCount; ++i) {
+            workers_.emplace_back([this] { work(); });
+        }
+    }
+
+    /// Runs the tasks that are still queued and joins the workers
+    ~ThreadPool() {
+        {
+            std::scoped_lock lock(mutex_);
+            stopping_ = true;
+        }
+        available_.notify_all();
+        workers_.clear();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void submit(std::function<void()> task) {
+        {
+            std::scoped_lock lock(mutex_);
+            tasks_.push_back(std::move(task));
+        }
+        available_.notify_one();
+    }
+
+    /// Runs queued tasks on the calling thread until the condition holds. The condition is checked whenever a task
+    /// finishes, so it has to become true through the tasks of this pool
+    template<typename CONDITION>
+    void helpUntil(CONDITION condition) {
+        std::unique_lock lock(mutex_);
+        while (!condition()) {
+            if (tasks_.empty()) {
+                finished_.wait(lock);
+                continue;
+            }
+            std::function<void()> task = std::move(tasks_.front());
+            tasks_.pop_front();
+            lock.unlock();
+            task();
+            lock.lock();
+            finished_.notify_all();
+        }
+    }
+
+    [[nodiscard]] std::size_t getThreadCount() const { return workers_.size(); }
+
+private:
+    void work() {
+        std::unique_lock lock(mutex_);
+        while (true) {
+            available_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+            if (tasks_.empty()) {
+                return;
+            }
+            std::function<void()> task = std::move(tasks_.front());
+            tasks_.pop_front();
+            lock.unlock();
+            task();
+            lock.lock();
+            finished_.notify_all();
+        }
+    }
+
+    std::mutex mutex_;
+    // Signaled when a task is submitted or the pool is stopped, and when a task has finished
+    std::condition_variable available_;
+    std::condition_variable finished_;
+    std::deque<std::function<void()>> tasks_;
+    bool stopping_ = false;
+    std::vector<std::jthread> workers_;
+};
@@ -0,0 +1,214 @@
+// MIT License
+//
+// Copyright (c) 2026 Levin Tertilt
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <concepts>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/// A tracing policy records spans and instant events of the processor and the providers. It is selected at compile
+/// time, so a disabled policy does not cost anything
+template<typename T>
+concept TracingPolicy = requires
+{
+    { T::ENABLED } -> std::convertible_to<bool>;
+    typename T::Scope;
+    requires std::constructible_from<typename T::Scope, std::string_view, std::string_view>;
+    T::instant(std::declval<std::string_view>(), std::declval<std::string_view>());
+};
+
+/// The default tracing policy, which records nothing
+struct NoTracing {
+    static constexpr bool ENABLED = false;
+
+    struct Scope {
+        constexpr Scope(std::string_view, std::string_view) noexcept {}
+    };
+
+    static constexpr void instant(std::string_view, std::string_view) noexcept {}
+};
+
+/// A tracing policy that records all events in memory, which can then be written in the Chrome trace event format and
+/// inspected with chrome://tracing or Perfetto. Every thread records into its own buffer, so threads only contend on
+/// the lock of their own buffer
+class ChromeTracing {
+public:
+    static constexpr bool ENABLED = true;
+
+    /// Records a complete event spanning the lifetime of the scope
+    class Scope {
+    public:
+        Scope(std::string_view name, std::string_view detail) :
+            name_(name),
+            detail_(detail),
+            start_(std::chrono::steady_clock::now()) {}
+        ~Scope() {
+            record({std::string(name_), std::string(detail_), 'X', start_, std::chrono::steady_clock::now() - start_});
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        std::string_view name_;
+        std::string_view detail_;
+        std::chrono::steady_clock::time_point start_;
+    };
+
+    static void instant(std::string_view name, std::string_view detail) {
+        record({std::string(name), std::string(detail), 'i', std::chrono::steady_clock::now(), {}});
+    }
+
+    /// Writes all recorded events as a JSON trace
+    static void writeJSON(std::ostream& stream);
+    static bool writeJSON(const std::filesystem::path& filepath) {
+        std::ofstream file(filepath, std::ios::binary | std::ios::trunc);
+        writeJSON(file);
+        return static_cast<bool>(file);
+    }
+
+    /// Discards all recorded events
+    static void clear();
+
+private:
+    struct Event {
+        std::string name;
+        std::string detail;
+        char phase;
+        std::chrono::steady_clock::time_point start;
+        std::chrono::steady_clock::duration duration;
+    };
+
+    struct ThreadBuffer {
+        std::uint32_t threadId;
+        std::mutex mutex;
+        std::vector<Event> events;
+    };
+
+    struct Registry {
+        std::mutex mutex;
+        std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    };
+
+    static Registry& getRegistry() {
+        static Registry registry;
+        return registry;
+    }
+
+    // The buffer is shared with the registry, so the events outlive the thread
+    static ThreadBuffer& getThreadBuffer() {
+        thread_local std::shared_ptr<ThreadBuffer> buffer = [] {
+            Registry& registry = getRegistry();
+            std::scoped_lock lock(registry.mutex);
+            auto created = std::make_shared<ThreadBuffer>();
+            created->threadId = static_cast<std::uint32_t>(registry.buffers.size() + 1);
+            registry.buffers.push_back(created);
+            return created;
+        }();
+        return *buffer;
+    }
+
+    static void record(Event event) {
+        ThreadBuffer& buffer = getThreadBuffer();
+        std::scoped_lock lock(buffer.mutex);
+        buffer.events.push_back(std::move(event));
+    }
+
+    static void writeEscaped(std::ostream& stream, std::string_view value);
+};
+
+inline void ChromeTracing::writeEscaped(std::ostream& stream, std::string_view value) {
+    constexpr char HEX[] = "0123456789abcdef";
+
+    stream << '"';
+    for (char c : value) {
+        if (c == '"' || c == '\\') {
+            stream << '\\' << c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            stream << "\\u00" << HEX[(c >> 4) & 0xf] << HEX[c & 0xf];
+        } else {
+            stream << c;
+        }
+    }
+    stream << '"';
+}
+
+inline void ChromeTracing::writeJSON(std::ostream& stream) {
+    using Microseconds = std::chrono::duration<double, std::micro>;
+
+    Registry& registry = getRegistry();
+    std::scoped_lock lock(registry.mutex);
+
+    // Timestamps are relative to the earliest event
+    auto origin = std::chrono::steady_clock::time_point::max();
+    for (const auto& buffer : registry.buffers) {
+        std::scoped_lock bufferLock(buffer->mutex);
+        for (const Event& event : buffer->events) {
+            origin = std::min(origin, event.start);
+        }
+    }
+
+    stream << "{\"traceEvents\":[";
+    bool first = true;
+    for (const auto& buffer : registry.buffers) {
+        std::scoped_lock bufferLock(buffer->mutex);
+        for (const Event& event : buffer->events) {
+            stream << (first ? "\n" : ",\n") << "{\"name\":";
+            writeEscaped(stream, event.name);
+            stream << ",\"cat\":\"glsl\",\"ph\":\"" << event.phase << "\",\"pid\":1,\"tid\":" << buffer->threadId
+                << ",\"ts\":" << std::format("{:.3f}", Microseconds(event.start - origin).count());
+            if (event.phase == 'X') {
+                stream << ",\"dur\":" << std::format("{:.3f}", Microseconds(event.duration).count());
+            } else {
+                stream << ",\"s\":\"t\"";
+            }
+            if (!event.detail.empty()) {
+                stream << ",\"args\":{\"detail\":";
+                writeEscaped(stream, event.detail);
+                stream << '}';
+            }
+            stream << '}';
+            first = false;
+        }
+    }
+    stream << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+inline void ChromeTracing::clear() {
+    Registry& registry = getRegistry();
+    std::scoped_lock lock(registry.mutex);
+    for (const auto& buffer : registry.buffers) {
+        std::scoped_lock bufferLock(buffer->mutex);
+        buffer->events.clear();
+    }
+}
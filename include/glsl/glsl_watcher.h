@@ -0,0 +1,350 @@
+// MIT License
+//
+// Copyright (c) 2026 Levin Tertilt
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "glsl_source_processor.h"
+
+#if !defined(__linux__)
+#error "ShaderWatcher requires inotify"
+#endif
+
+#include <chrono>
+#include <functional>
+#include <set>
+#include <stop_token>
+#include <utility>
+
+#include <poll.h>
+#include <sys/inotify.h>
+
+/// A file below one of the roots of SplitDirectories, named like the processor refers to it
+struct FileChange {
+    SourceType type;
+    std::string name;
+
+    auto operator<=>(const FileChange&) const = default;
+};
+
+/// Records which files every shader depends on, e.g. as reported by GLSLSourceProcessor::getShaderSource, so that
+/// changed files can be mapped to the shaders that have to be processed again
+class IncludeGraph {
+public:
+    void setDependencies(const std::string& shader, const std::vector<std::string>& includedFiles) {
+        remove(shader);
+        for (const std::string& include : includedFiles) {
+            dependents_[include].insert(shader);
+        }
+        dependencies_.insert_or_assign(shader, includedFiles);
+    }
+
+    void remove(const std::string& shader) {
+        auto it = dependencies_.find(shader);
+        if (it == dependencies_.end()) {
+            return;
+        }
+        for (const std::string& include : it->second) {
+            if (auto dependents = dependents_.find(include); dependents != dependents_.end()) {
+                dependents->second.erase(shader);
+                if (dependents->second.empty()) {
+                    dependents_.erase(dependents);
+                }
+            }
+        }
+        dependencies_.erase(it);
+    }
+
+    /// Returns the tracked shaders that are affected by any of the changes, in a sorted order
+    [[nodiscard]] std::vector<std::string> getAffectedShaders(const std::vector<FileChange>& changes) const {
+        std::set<std::string> affected;
+        for (const FileChange& change : changes) {
+            if (change.type == SourceType::Source) {
+                if (dependencies_.contains(change.name)) {
+                    affected.insert(change.name);
+                }
+            } else if (auto it = dependents_.find(change.name); it != dependents_.end()) {
+                affected.insert(it->second.begin(), it->second.end());
+            }
+        }
+        return {affected.begin(), affected.end()};
+    }
+
+    /// Adds the tracked files of the given type below the directory prefix to the changes, e.g. once the directory has
+    /// been moved away
+    void collectFiles(SourceType type, std::string_view prefix, std::set<FileChange>& changes) const {
+        if (type == SourceType::Source) {
+            for (const auto& [shader, includes] : dependencies_) {
+                if (shader.starts_with(prefix)) {
+                    changes.insert(FileChange{type, shader});
+                }
+            }
+        } else {
+            for (const auto& [include, shaders] : dependents_) {
+                if (include.starts_with(prefix)) {
+                    changes.insert(FileChange{type, include});
+                }
+            }
+        }
+    }
+
+    [[nodiscard]] std::vector<std::string> getShaders() const {
+        std::vector<std::string> shaders;
+        for (const auto& [shader, includes] : dependencies_) {
+            shaders.push_back(shader);
+        }
+        return shaders;
+    }
+
+private:
+    std::unordered_map<std::string, std::vector<std::string>> dependencies_;
+    std::unordered_map<std::string, std::set<std::string>> dependents_;
+};
+
+/// Watches the source and include directories of SplitDirectories for modifications. Bursts of changes, like an editor
+/// saving multiple files, are collected until no further change happened for the debounce interval, and then mapped
+/// to the affected shaders through the include graph
+class ShaderWatcher {
+public:
+    using Callback = std::function<void(const std::vector<std::string>& affectedShaders)>;
+
+    struct Changes {
+        std::vector<FileChange> files;
+        // Set if the kernel dropped events, in which case every shader has to be considered as affected
+        bool overflowed = false;
+    };
+
+    static std::optional<ShaderWatcher> create(const SplitDirectories& directories,
+        std::chrono::milliseconds debounce = std::chrono::milliseconds(100), LoggingImpl log =
+        STDIOLogging::logAsError);
+
+    ShaderWatcher(ShaderWatcher&& other) noexcept :
+        fd_(std::exchange(other.fd_, -1)),
+        debounce_(other.debounce_),
+        log_(other.log_),
+        watches_(std::move(other.watches_)),
+        graph_(std::move(other.graph_)) {}
+    ShaderWatcher& operator=(ShaderWatcher&&) = delete;
+    ~ShaderWatcher() {
+        if (fd_ >= 0) {
+            ::close(fd_);
+        }
+    }
+
+    [[nodiscard]] IncludeGraph& getIncludeGraph() { return graph_; }
+    [[nodiscard]] const IncludeGraph& getIncludeGraph() const { return graph_; }
+
+    /// Waits up to the timeout for a change, and then until the burst of changes has settled
+    Changes waitForChanges(std::chrono::milliseconds timeout);
+
+    /// Returns the shaders affected by the changes
+    [[nodiscard]] std::vector<std::string> getAffectedShaders(const Changes& changes) const {
+        return changes.overflowed ? graph_.getShaders() : graph_.getAffectedShaders(changes.files);
+    }
+
+    /// Invokes the callback with the affected shaders after every burst of changes, until a stop is requested. The
+    /// callback may update the include graph
+    void run(std::stop_token stop, const Callback& callback) {
+        constexpr auto POLL_INTERVAL = std::chrono::milliseconds(100);
+
+        while (!stop.stop_requested()) {
+            Changes changes = waitForChanges(POLL_INTERVAL);
+            if (std::vector<std::string> affected = getAffectedShaders(changes); !affected.empty()) {
+                callback(affected);
+            }
+        }
+    }
+
+private:
+    static constexpr std::uint32_t WATCH_MASK = IN_CLOSE_WRITE | IN_MODIFY | IN_CREATE | IN_DELETE | IN_MOVED_FROM |
+        IN_MOVED_TO | IN_MOVE_SELF;
+    // Changes are reported after at most this many debounce intervals, even if the burst has not settled yet
+    static constexpr int MAX_DEBOUNCE_INTERVALS = 10;
+
+    struct Watch {
+        SourceType type;
+        std::filesystem::path directory;
+        // The directory relative to the root, which prefixes the names of its files
+        std::string prefix;
+    };
+
+    ShaderWatcher(int fd, std::chrono::milliseconds debounce, LoggingImpl log) :
+        fd_(fd),
+        debounce_(debounce),
+        log_(log) {}
+
+    // Watches the directory and all of its subdirectories, and optionally reports the files found in them as changes.
+    // Symbolic links to directories are not followed, and a directory that is already watched under another name is
+    // skipped, so neither can lead into a cycle
+    void addWatches(SourceType type, const std::filesystem::path& directory, const std::string& prefix,
+        std::set<FileChange>* found, bool root = false);
+    // Stops watching the directory with the given prefix and all of its subdirectories, except for the given watch
+    void removeWatches(SourceType type, const std::string& prefix, int keep = -1);
+    // Reads all pending events, returns false if there were none
+    bool readEvents(std::set<FileChange>& changes, bool& overflowed);
+
+    int fd_;
+    std::chrono::milliseconds debounce_;
+    LoggingImpl log_;
+    std::unordered_map<int, Watch> watches_;
+    IncludeGraph graph_;
+};
+
+inline std::optional<ShaderWatcher> ShaderWatcher::create(const SplitDirectories& directories,
+    std::chrono::milliseconds debounce, LoggingImpl log) {
+    int fd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0) {
+        log("Failed to initialize inotify");
+        return std::nullopt;
+    }
+
+    ShaderWatcher watcher(fd, debounce, log);
+    watcher.addWatches(SourceType::Source, directories.getSourceRoot(), "", nullptr, true);
+    watcher.addWatches(SourceType::Include, directories.getIncludeRoot(), "", nullptr, true);
+    if (watcher.watches_.empty()) {
+        log("Failed to watch any of the shader directories");
+        return std::nullopt;
+    }
+    return watcher;
+}
+
+inline void ShaderWatcher::addWatches(SourceType type, const std::filesystem::path& directory,
+    const std::string& prefix, std::set<FileChange>* found, bool root) {
+    // The roots themselves may be symbolic links, everything below them is watched as it is
+    int wd = ::inotify_add_watch(fd_, directory.c_str(), WATCH_MASK | IN_ONLYDIR | (root ? 0 : IN_DONT_FOLLOW));
+    if (wd < 0) {
+        log_(std::format("Failed to watch directory: {}", directory.string()));
+        return;
+    }
+
+    std::error_code ec;
+    if (auto it = watches_.find(wd); it != watches_.end() && (it->second.type != type || it->second.prefix != prefix)) {
+        // The directory is either reachable through another path, e.g. a bind mount, or it has been moved without
+        // the watcher noticing, in which case its old path is gone
+        if (std::filesystem::is_directory(it->second.directory, ec)) {
+            return;
+        }
+        removeWatches(it->second.type, it->second.prefix, wd);
+    }
+    watches_.insert_or_assign(wd, Watch{type, directory, prefix});
+
+    for (const auto& entry : std::filesystem::directory_iterator(directory, ec)) {
+        std::string name = prefix + entry.path().filename().string();
+        if (entry.is_symlink(ec) && entry.is_directory(ec)) {
+            continue;
+        }
+        if (entry.is_directory(ec)) {
+            addWatches(type, entry.path(), name + "/", found);
+        } else if (found != nullptr) {
+            found->insert(FileChange{type, std::move(name)});
+        }
+    }
+}
+
+inline void ShaderWatcher::removeWatches(SourceType type, const std::string& prefix, int keep) {
+    for (auto it = watches_.begin(); it != watches_.end();) {
+        if (it->second.type == type && it->second.prefix.starts_with(prefix) && it->first != keep) {
+            // The IN_IGNORED event of the removed watch is dropped, since the descriptor is no longer known
+            ::inotify_rm_watch(fd_, it->first);
+            it = watches_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+inline bool ShaderWatcher::readEvents(std::set<FileChange>& changes, bool& overflowed) {
+    alignas(inotify_event) char buffer[64 * 1024];
+
+    bool any = false;
+    while (true) {
+        ssize_t length = ::read(fd_, buffer, sizeof(buffer));
+        if (length <= 0) {
+            return any;
+        }
+        any = true;
+
+        for (ssize_t offset = 0; offset < length;) {
+            const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+            offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+
+            if (event->mask & IN_Q_OVERFLOW) {
+                overflowed = true;
+                continue;
+            }
+            auto it = watches_.find(event->wd);
+            if (it == watches_.end()) {
+                continue;
+            }
+            if (event->mask & IN_IGNORED) {
+                watches_.erase(it);
+                continue;
+            }
+
+            // Copied, since adding or removing watches may invalidate the iterator
+            Watch watch = it->second;
+            if (event->mask & IN_MOVE_SELF) {
+                // Only a moved root ends up here, subdirectories are already handled by the event of their parent
+                log_(std::format("Watched directory has been moved: {}", watch.directory.string()));
+                graph_.collectFiles(watch.type, watch.prefix, changes);
+                removeWatches(watch.type, watch.prefix);
+                continue;
+            }
+            if (event->len == 0) {
+                continue;
+            }
+
+            std::string name = watch.prefix + event->name;
+            if ((event->mask & IN_ISDIR) && (event->mask & IN_MOVED_FROM)) {
+                // The watches keep following the moved directory, so they are dropped along with their names. If it
+                // is moved to another watched directory, it is watched again under its new name by IN_MOVED_TO
+                graph_.collectFiles(watch.type, name + "/", changes);
+                removeWatches(watch.type, name + "/");
+            } else if ((event->mask & IN_ISDIR) && (event->mask & (IN_CREATE | IN_MOVED_TO))) {
+                addWatches(watch.type, watch.directory / event->name, name + "/", &changes);
+            } else if (!(event->mask & IN_ISDIR)) {
+                changes.insert(FileChange{watch.type, std::move(name)});
+            }
+        }
+    }
+}
+
+inline ShaderWatcher::Changes ShaderWatcher::waitForChanges(std::chrono::milliseconds timeout) {
+    Changes result;
+    std::set<FileChange> changes;
+
+    pollfd descriptor{fd_, POLLIN, 0};
+    if (::poll(&descriptor, 1, static_cast<int>(timeout.count())) <= 0 ||
+        !readEvents(changes, result.overflowed)) {
+        return result;
+    }
+
+    // Keeps collecting until no event arrived within the debounce interval
+    for (int i = 1; i < MAX_DEBOUNCE_INTERVALS; ++i) {
+        if (::poll(&descriptor, 1, static_cast<int>(debounce_.count())) <= 0 ||
+            !readEvents(changes, result.overflowed)) {
+            break;
+        }
+    }
+
+    result.files.assign(changes.begin(), changes.end());
+    return result;
+}
@@ -0,0 +1,83 @@
+// MIT License
+//
+// Copyright (c) 2026 Levin Tertilt
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Runs all registered tests, or those whose name contains one of the filters given on the command line
+
+#include "test.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <iostream>
+#include <vector>
+
+struct RegisteredTest {
+    std::string name;
+    void (*function)();
+};
+
+static std::vector<RegisteredTest>& getTests() {
+    static std::vector<RegisteredTest> tests;
+    return tests;
+}
+
+static std::atomic<std::size_t> failedChecks = 0;
+
+bool registerTest(std::string name, void (*function)()) {
+    getTests().push_back({std::move(name), function});
+    return true;
+}
+
+void checkCondition(bool condition, const char* expression, const char* file, int line) {
+    if (!condition) {
+        ++failedChecks;
+        std::cerr << file << ':' << line << ": check failed: " << expression << std::endl;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::string_view> filters(argv + 1, argv + argc);
+    std::size_t run = 0;
+    std::size_t failed = 0;
+    for (const RegisteredTest& test : getTests()) {
+        if (!filters.empty() && std::ranges::none_of(filters, [&](std::string_view filter) {
+            return test.name.find(filter) != std::string::npos;
+        })) {
+            continue;
+        }
+
+        std::size_t failedBefore = failedChecks;
+        try {
+            test.function();
+        } catch (const std::exception& e) {
+            ++failedChecks;
+            std::cerr << test.name << ": unexpected exception: " << e.what() << std::endl;
+        }
+        bool passed = failedChecks == failedBefore;
+        std::cout << (passed ? "passed " : "FAILED ") << test.name << std::endl;
+        ++run;
+        failed += passed ? 0 : 1;
+    }
+
+    std::cout << run - failed << " of " << run << " tests passed" << std::endl;
+    return failed == 0 && run > 0 ? 0 : 1;
+}
@@ -0,0 +1,73 @@
+// MIT License
+//
+// Copyright (c) 2026 Levin Tertilt
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <string_view>
+
+/// Registers a test, tests are registered by static initializers through GLSL_TEST
+bool registerTest(std::string name, void (*function)());
+
+/// Marks the running test as failed and reports the expression if the condition does not hold. May be called from
+/// any thread
+void checkCondition(bool condition, const char* expression, const char* file, int line);
+
+/// Defines and registers a test, which can then be selected by its name on the command line
+#define GLSL_TEST(NAME) \
+    static void NAME(); \
+    [[maybe_unused]] static const bool NAME##Registered = registerTest(#NAME, NAME); \
+    static void NAME()
+
+/// Checks a condition, the test continues after a failed check to report further failures
+#define GLSL_CHECK(CONDITION) checkCondition(static_cast<bool>(CONDITION), #CONDITION, __FILE__, __LINE__)
+
+/// A directory with a unique name below the temporary directory, which is removed together with its files
+class TemporaryDirectory {
+public:
+    TemporaryDirectory() :
+        path_(std::filesystem::temp_directory_path() / ("glsl_sp_test_" + std::to_string(std::random_device{}()))) {
+        std::filesystem::create_directories(path_);
+    }
+    ~TemporaryDirectory() {
+        std::error_code ec;
+        std::filesystem::remove_all(path_, ec);
+    }
+
+    TemporaryDirectory(const TemporaryDirectory&) = delete;
+    TemporaryDirectory& operator=(const TemporaryDirectory&) = delete;
+
+    /// Writes the file below the directory, creating its parent directories
+    void write(const std::filesystem::path& relative, std::string_view contents) const {
+        std::filesystem::path filepath = path_ / relative;
+        std::filesystem::create_directories(filepath.parent_path());
+        std::ofstream(filepath, std::ios::binary | std::ios::trunc) << contents;
+    }
+
+    [[nodiscard]] const std::filesystem::path& getPath() const { return path_; }
+
+private:
+    std::filesystem::path path_;
+};
@@ -0,0 +1,134 @@
+// MIT License
+//
+// Copyright (c) 2026 Levin Tertilt
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "test.h"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+#include <glsl/glsl_batch.h>
+
+// Serves sources from memory, but throws for the shader named "throwing.glsl"
+struct ThrowingSourceProvider {
+    MemorySourceProvider memory;
+
+    std::optional<std::string> getSource(SourceType type, std::string_view name) const {
+        if (name == "throwing.glsl") {
+            throw std::runtime_error("provider");
+        }
+        return memory.getSource(type, name);
+    }
+};
+
+static std::vector<BatchJob> makeJobs(std::size_t count) {
+    std::vector<BatchJob> jobs;
+    for (std::size_t i = 0; i < count; ++i) {
+        jobs.push_back({"shader.glsl", {{"VARIANT", std::to_string(i)}}});
+    }
+    return jobs;
+}
+
+static GLSLSourceProcessor<SharedSourceProvider<ThrowingSourceProvider>> makeProcessor() {
+    ThrowingSourceProvider provider;
+    provider.memory.addSource(SourceType::Source, "shader.glsl", "#include \"common.glsl\"\nvoid main() {}\n");
+    provider.memory.addSource(SourceType::Include, "common.glsl", "float common;\n");
+    return GLSLSourceProcessor(SharedSourceProvider(std::move(provider)), "#version 450 core", DISABLED_LOGGING);
+}
+
+GLSL_TEST(batchDeliversEveryShaderOnce) {
+    auto processor = makeProcessor();
+    std::vector<BatchJob> jobs = makeJobs(100);
+    jobs.push_back({"missing.glsl", {}});
+
+    for (BatchCallbackThread thread : {BatchCallbackThread::Worker, BatchCallbackThread::Caller}) {
+        BatchOptions options;
+        options.threadCount = 4;
+        options.callbackThread = thread;
+        options.maxQueued = 2;
+
+        std::mutex mutex;
+        std::vector<int> delivered(jobs.size());
+        std::size_t failed = processBatch(processor, jobs, [&](BatchResult& result) {
+            std::scoped_lock lock(mutex);
+            ++delivered[result.index];
+            if (result.index < 100) {
+                GLSL_CHECK(result.source.has_value() &&
+                    result.source->find("#define VARIANT " + std::to_string(result.index) + "\n") != std::string::npos);
+                GLSL_CHECK(result.includedFiles == std::vector<std::string>{"common.glsl"});
+            }
+        }, options);
+
+        GLSL_CHECK(failed == 1);
+        GLSL_CHECK(std::ranges::all_of(delivered, [](int count) { return count == 1; }));
+    }
+}
+
+GLSL_TEST(batchRethrowsCallbackExceptions) {
+    auto processor = makeProcessor();
+    std::vector<BatchJob> jobs = makeJobs(100);
+
+    for (BatchCallbackThread thread : {BatchCallbackThread::Worker, BatchCallbackThread::Caller}) {
+        BatchOptions options;
+        options.threadCount = 4;
+        options.callbackThread = thread;
+        options.maxQueued = 1;
+
+        std::atomic<std::size_t> calls = 0;
+        bool caught = false;
+        try {
+            processBatch(processor, jobs, [&](BatchResult& result) {
+                ++calls;
+                if (result.index == 10) {
+                    throw std::runtime_error("callback");
+                }
+            }, options);
+        } catch (const std::runtime_error& e) {
+            caught = std::string_view(e.what()) == "callback";
+        }
+        GLSL_CHECK(caught);
+        GLSL_CHECK(calls <= jobs.size());
+    }
+}
+
+GLSL_TEST(batchRethrowsProviderExceptions) {
+    auto processor = makeProcessor();
+    std::vector<BatchJob> jobs = makeJobs(50);
+    jobs.insert(jobs.begin() + 25, {"throwing.glsl", {}});
+
+    for (BatchCallbackThread thread : {BatchCallbackThread::Worker, BatchCallbackThread::Caller}) {
+        BatchOptions options;
+        options.threadCount = 4;
+        options.callbackThread = thread;
+        options.maxQueued = 1;
+
+        bool caught = false;
+        try {
+            processBatch(processor, jobs, [](BatchResult&) {}, options);
+        } catch (const std::runtime_error& e) {
+            caught = std::string_view(e.what()) == "provider";
+        }
+        GLSL_CHECK(caught);
+    }
+}
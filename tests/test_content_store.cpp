@@ -0,0 +1,76 @@
+// MIT License
+//
+// Copyright (c) 2026 Levin Tertilt
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "test.h"
+
+#include <thread>
+#include <vector>
+
+#include <glsl/glsl_content_store.h>
+
+GLSL_TEST(contentStoreStoresIdenticalContentsOnce) {
+    ContentStore store;
+    ContentStore::Handle first = store.insert("void main() {}");
+    ContentStore::Handle second = store.insert("void main() {}");
+    ContentStore::Handle other = store.insert("float x;");
+
+    GLSL_CHECK(first == second);
+    GLSL_CHECK(first != other);
+    GLSL_CHECK(first->hash == hashContent("void main() {}"));
+    GLSL_CHECK(store.getUniqueCount() == 2);
+    GLSL_CHECK(store.getStoredBytes() == first->data.size() + other->data.size());
+}
+
+GLSL_TEST(contentStoreReleasesUnusedContents) {
+    ContentStore store;
+    ContentStore::Handle kept = store.insert("kept");
+    store.insert("released");
+    GLSL_CHECK(store.getUniqueCount() == 1);
+
+    // Reinserting released contents stores them again
+    ContentStore::Handle reinserted = store.insert("released");
+    GLSL_CHECK(store.getUniqueCount() == 2);
+    GLSL_CHECK(reinserted->data == "released");
+}
+
+GLSL_TEST(contentStoreDeduplicatesConcurrentInserts) {
+    constexpr int CONTENT_COUNT = 200;
+    ContentStore store;
+    std::vector<std::vector<ContentStore::Handle>> handles(8);
+    {
+        std::vector<std::jthread> threads;
+        for (auto& threadHandles : handles) {
+            threads.emplace_back([&store, &threadHandles] {
+                for (int i = 0; i < CONTENT_COUNT; ++i) {
+                    threadHandles.push_back(store.insert("content " + std::to_string(i)));
+                }
+            });
+        }
+    }
+
+    GLSL_CHECK(store.getUniqueCount() == CONTENT_COUNT);
+    for (const auto& threadHandles : handles) {
+        for (int i = 0; i < CONTENT_COUNT; ++i) {
+            GLSL_CHECK(threadHandles[i] == handles[0][i]);
+        }
+    }
+}
@@ -0,0 +1,89 @@
+// MIT License
+//
+// Copyright (c) 2026 Levin Tertilt
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "test.h"
+
+#include <map>
+
+#include <glsl/glsl_flat_map.h>
+
+// Inserts and erases random keys until erased markers exist, and compares the map and its copies with a std::map
+GLSL_TEST(flatMapCopiesAfterErasing) {
+    for (std::uint32_t seed = 0; seed < 20; ++seed) {
+        std::mt19937 random(seed);
+        StringMap<std::uint32_t> map;
+        std::map<std::string, std::uint32_t> reference;
+        for (int step = 0; step < 400; ++step) {
+            std::string key = "key" + std::to_string(random() % 64);
+            if (random() % 3 == 0) {
+                GLSL_CHECK(map.erase(key) == reference.erase(key));
+            } else {
+                std::uint32_t value = random();
+                map.insert_or_assign(key, value);
+                reference.insert_or_assign(key, value);
+            }
+        }
+
+        StringMap<std::uint32_t> copy(map);
+        StringMap<std::uint32_t> assigned;
+        assigned = map;
+        for (const StringMap<std::uint32_t>* actual : {&map, &copy, &assigned}) {
+            GLSL_CHECK(actual->size() == reference.size());
+            for (std::uint32_t i = 0; i < 64; ++i) {
+                std::string key = "key" + std::to_string(i);
+                auto expected = reference.find(key);
+                auto it = actual->find(key);
+                GLSL_CHECK((it == actual->end()) == (expected == reference.end()));
+                GLSL_CHECK(it == actual->end() || it->second == expected->second);
+            }
+        }
+    }
+}
+
+GLSL_TEST(flatMapErasesWhileIterating) {
+    FlatHashMap<int, int> map;
+    for (int i = 0; i < 1000; ++i) {
+        map.try_emplace(i, i);
+    }
+    for (auto it = map.begin(); it != map.end();) {
+        it = it->first % 2 == 0 ? map.erase(it) : std::next(it);
+    }
+
+    GLSL_CHECK(map.size() == 500);
+    int sum = 0;
+    for (const auto& [key, value] : map) {
+        GLSL_CHECK(key % 2 == 1 && key == value);
+        sum += key;
+    }
+    GLSL_CHECK(sum == 250000);
+}
+
+GLSL_TEST(flatMapFindsStringViews) {
+    StringMap<int> map;
+    map.try_emplace("include.glsl", 1);
+    std::string_view key = "include.glsl";
+    GLSL_CHECK(map.contains(key));
+    GLSL_CHECK(map.find(key.substr(0, 7)) == map.end());
+
+    StringMap<int> moved(std::move(map));
+    GLSL_CHECK(moved.size() == 1 && moved.find(key)->second == 1);
+}
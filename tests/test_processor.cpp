@@ -0,0 +1,88 @@
+// MIT License
+//
+// Copyright (c) 2026 Levin Tertilt
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "test.h"
+
+#include <map>
+#include <mutex>
+
+#include <glsl/glsl_source_processor.h>
+#include <glsl/glsl_thread_pool.h>
+
+// Serves sources from memory and counts how often every include has been read
+struct CountingSourceProvider {
+    MemorySourceProvider memory;
+    mutable std::mutex mutex;
+    mutable std::map<std::string, int, std::less<>> includeReads;
+
+    std::optional<std::string> getSource(SourceType type, std::string_view name) const {
+        if (type == SourceType::Include) {
+            std::scoped_lock lock(mutex);
+            ++includeReads[std::string(name)];
+        }
+        return memory.getSource(type, name);
+    }
+};
+
+// A shader including a chain of the given length, every header includes the next one
+static GLSLSourceProcessor<SharedSourceProvider<CountingSourceProvider>> makeChainProcessor(std::size_t length) {
+    SharedSourceProvider<CountingSourceProvider> provider;
+    provider.get().memory.addSource(SourceType::Source, "shader.glsl", "#include \"header_1.glsl\"\nvoid main() {}\n");
+    for (std::size_t i = 1; i <= length; ++i) {
+        std::string source = i < length ? std::format("#include \"header_{}.glsl\"\n", i + 1) : "";
+        provider.get().memory.addSource(SourceType::Include, std::format("header_{}.glsl", i),
+            source + std::format("float header{};\n", i));
+    }
+    GLSLSourceProcessor processor(std::move(provider), "#version 450 core", DISABLED_LOGGING);
+    processor.setMaxIncludeDepth(4);
+    return processor;
+}
+
+GLSL_TEST(prefetchMatchesExpansionAtMaximumIncludeDepth) {
+    auto sequential = makeChainProcessor(4);
+    auto prefetching = makeChainProcessor(4);
+    prefetching.setThreadPool(std::make_shared<ThreadPool>(2));
+
+    std::vector<std::string> sequentialFiles;
+    std::vector<std::string> prefetchingFiles;
+    std::optional<std::string> expected = sequential.getShaderSource("shader.glsl", sequentialFiles);
+    GLSL_CHECK(expected.has_value() && expected->find("float header4;") != std::string::npos);
+    GLSL_CHECK(prefetching.getShaderSource("shader.glsl", prefetchingFiles) == expected);
+    GLSL_CHECK(prefetchingFiles == sequentialFiles);
+
+    GLSL_CHECK(prefetching.getStats().includeExpansions.load() == sequential.getStats().includeExpansions.load());
+    GLSL_CHECK(prefetching.getStats().bytesEmitted.load() == sequential.getStats().bytesEmitted.load());
+    GLSL_CHECK(prefetching.getSourceProvider().get().includeReads ==
+        sequential.getSourceProvider().get().includeReads);
+    GLSL_CHECK(sequential.getSourceProvider().get().includeReads.size() == 4);
+}
+
+GLSL_TEST(prefetchSkipsIncludesBeyondMaximumDepth) {
+    auto sequential = makeChainProcessor(5);
+    auto prefetching = makeChainProcessor(5);
+    prefetching.setThreadPool(std::make_shared<ThreadPool>(2));
+
+    GLSL_CHECK(!sequential.getShaderSource("shader.glsl").has_value());
+    GLSL_CHECK(!prefetching.getShaderSource("shader.glsl").has_value());
+    GLSL_CHECK(!sequential.getSourceProvider().get().includeReads.contains("header_5.glsl"));
+    GLSL_CHECK(!prefetching.getSourceProvider().get().includeReads.contains("header_5.glsl"));
+}
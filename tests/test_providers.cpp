@@ -0,0 +1,143 @@
+// MIT License
+//
+// Copyright (c) 2026 Levin Tertilt
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "test.h"
+
+#include <thread>
+#include <vector>
+
+#include <glsl/glsl_source_processor.h>
+
+// A shader tree where every shader includes a shared header and one of several leaf headers
+static void writeShaderTree(const TemporaryDirectory& directory, int shaderCount) {
+    directory.write("include/common.glsl", "#include \"leaf_0.glsl\"\nfloat common;\n");
+    for (int i = 0; i < shaderCount; ++i) {
+        directory.write("include/leaf_" + std::to_string(i) + ".glsl", "float leaf" + std::to_string(i) + ";\n");
+        directory.write("src/shader_" + std::to_string(i) + ".glsl", "#include \"common.glsl\"\n#include \"leaf_" +
+            std::to_string(i) + ".glsl\"\nvoid main() {}\n");
+    }
+}
+
+GLSL_TEST(sharedSourceProviderCopiesReferToOneProvider) {
+    SharedSourceProvider<MemorySourceProvider> provider;
+    SharedSourceProvider<MemorySourceProvider> copy(provider);
+    provider.get().addSource(SourceType::Include, "a.glsl", "a");
+
+    GLSL_CHECK(&copy.get() == &provider.get());
+    GLSL_CHECK(copy.getSource(SourceType::Include, "a.glsl") == "a");
+}
+
+// Processors on several threads share one synchronized cache and have to produce the same outputs as a single one
+GLSL_TEST(sharedProviderServesConcurrentProcessors) {
+    constexpr int SHADER_COUNT = 32;
+    TemporaryDirectory directory;
+    writeShaderTree(directory, SHADER_COUNT);
+
+    using Provider = SharedSourceProvider<FileSourceProvider<SynchronizedFileProvider<CachedFileProvider>>>;
+    Provider provider(FileSourceProvider(SynchronizedFileProvider<CachedFileProvider>{},
+        SplitDirectories(directory.getPath()), DISABLED_LOGGING));
+
+    GLSLSourceProcessor expectedProcessor(FileSourceProvider(SillyFileProvider{},
+        SplitDirectories(directory.getPath())), "#version 450 core", DISABLED_LOGGING);
+    std::vector<std::string> expected;
+    for (int i = 0; i < SHADER_COUNT; ++i) {
+        expected.push_back(expectedProcessor.getShaderSource("shader_" + std::to_string(i) + ".glsl").value_or(""));
+    }
+
+    {
+        std::vector<std::jthread> threads;
+        for (int thread = 0; thread < 8; ++thread) {
+            threads.emplace_back([&provider, &expected, thread] {
+                GLSLSourceProcessor processor(provider, "#version 450 core", DISABLED_LOGGING);
+                for (int run = 0; run < 4; ++run) {
+                    for (int i = 0; i < SHADER_COUNT; ++i) {
+                        int shader = (i + thread) % SHADER_COUNT;
+                        std::optional<std::string> source =
+                            processor.getShaderSource("shader_" + std::to_string(shader) + ".glsl");
+                        GLSL_CHECK(source == expected[shader]);
+                    }
+                }
+            });
+        }
+    }
+
+    // Every file was read once, all other requests were cache hits
+    provider.get().getImpl().withImpl([](const CachedFileProvider& cache) {
+        GLSL_CHECK(cache.getStats().cacheMisses.load() == 2 * SHADER_COUNT + 1);
+        GLSL_CHECK(cache.getContentStore().getUniqueCount() == 2 * SHADER_COUNT + 1);
+    });
+}
+
+// Copies of a cached provider share their content store, even when they are used on different threads
+GLSL_TEST(cachedProviderCopiesShareTheStore) {
+    TemporaryDirectory directory;
+    directory.write("include/a.glsl", "float a;\n");
+    directory.write("include/b.glsl", "float a;\n");
+    CachedFileProvider provider;
+    GLSL_CHECK(provider.getString(directory.getPath() / "include" / "a.glsl") == "float a;\n");
+    {
+        std::vector<std::jthread> threads;
+        for (int thread = 0; thread < 8; ++thread) {
+            threads.emplace_back([&provider, &directory, thread] {
+                CachedFileProvider copy(provider);
+                GLSL_CHECK(&copy.getContentStore() == &provider.getContentStore());
+                for (int i = 0; i < 100; ++i) {
+                    std::filesystem::path file = directory.getPath() / "include" /
+                        ((i + thread) % 2 == 0 ? "a.glsl" : "b.glsl");
+                    GLSL_CHECK(copy.getString(file) == "float a;\n");
+                }
+                GLSL_CHECK(copy.getContentStore().getUniqueCount() == 1);
+            });
+        }
+    }
+    GLSL_CHECK(provider.getContentStore().getUniqueCount() == 1);
+}
+
+// Missing files are remembered until their directory changes, existing files are read without querying the directory
+template<FileProviderImpl IMPL>
+static void checkNegativeCache(std::uint64_t fileStatCalls) {
+    TemporaryDirectory directory;
+    directory.write("include/existing.glsl", "float a;\n");
+    std::filesystem::path missing = directory.getPath() / "include" / "missing.glsl";
+    IMPL provider;
+
+    GLSL_CHECK(provider.getString(directory.getPath() / "include" / "existing.glsl") == "float a;\n");
+    GLSL_CHECK(provider.getStats().statCalls.load() == fileStatCalls);
+
+    GLSL_CHECK(!provider.getString(missing).has_value());
+    std::uint64_t misses = provider.getStats().cacheMisses.load();
+    GLSL_CHECK(!provider.getString(missing).has_value());
+    GLSL_CHECK(provider.getStats().cacheMisses.load() == misses);
+
+    directory.write("include/missing.glsl", "float b;\n");
+    // Some file systems only store the write time with a coarse resolution
+    std::filesystem::last_write_time(missing.parent_path(),
+        std::filesystem::last_write_time(missing.parent_path()) + std::chrono::seconds(2));
+    GLSL_CHECK(provider.getString(missing) == "float b;\n");
+    GLSL_CHECK(provider.getStats().stringsReturned.load() == 2);
+}
+
+GLSL_TEST(cachedProvidersRememberMissingFiles) {
+    // The POSIX read queries the size of the file, the smart cache additionally its write time and size
+    checkNegativeCache<CachedFileProvider>(GLSL_SP_POSIX_IO);
+    checkNegativeCache<SmartCachedFileProvider>(GLSL_SP_POSIX_IO + 2);
+}
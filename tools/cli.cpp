@@ -0,0 +1,389 @@
+// MIT License
+//
+// Copyright (c) 2026 Levin Tertilt
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Preprocesses a whole manifest of shaders in parallel, e.g. as part of an offline build. Every line of the manifest
+// describes one output:
+//
+//     <shader> <output> [NAME[=VALUE]...]
+//
+// Empty lines and lines starting with '#' are ignored. Outputs are only written if their contents changed, so that
+// downstream build steps are not triggered needlessly. In watch mode, the shader directories are watched after the
+// initial build and the outputs depending on modified files are processed again
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <charconv>
+#include <csignal>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <unistd.h>
+
+#include <glsl/glsl_batch.h>
+#include <glsl/glsl_source_processor.h>
+#include <glsl/glsl_watcher.h>
+
+using CliFileProvider = FileSourceProvider<SynchronizedFileProvider<SmartCachedFileProvider>>;
+using CliSourceProvider = SharedSourceProvider<CliFileProvider>;
+using CliProcessor = GLSLSourceProcessor<CliSourceProvider>;
+
+struct CliOptions {
+    std::filesystem::path manifest;
+    std::filesystem::path root = "shaders";
+    std::string glslVersion = "#version 450 core";
+    unsigned jobs = std::max(1u, std::thread::hardware_concurrency());
+    bool depfiles = false;
+    bool watch = false;
+    unsigned debounceMs = 100;
+    // Number of headers listed in the include report, 0 if no report is printed
+    std::size_t reportLimit = 0;
+};
+
+struct ManifestEntry {
+    std::string shader;
+    std::filesystem::path output;
+    std::vector<std::pair<std::string, std::string>> definitions;
+};
+
+enum class EntryResult {
+    Written,
+    Unchanged,
+    Failed
+};
+
+static void printUsage() {
+    std::cerr << "Usage: glsl_sp_cli [options] <manifest>\n"
+                 "  -j, --jobs <count>      Number of worker threads (default: all cores)\n"
+                 "  -r, --root <directory>  Shader root containing src/ and include/ (default: shaders)\n"
+                 "  --glsl-version <line>   Version directive of the outputs (default: #version 450 core)\n"
+                 "  --depfiles              Writes a Makefile style <output>.d next to every output\n"
+                 "  --watch                 Keeps running and rebuilds outputs whenever their files change\n"
+                 "  --debounce <ms>         Time without changes before a rebuild starts (default: 100)\n"
+                 "  --report [count]        Prints the headers contributing most to the outputs (default: 20)\n";
+}
+
+static std::optional<CliOptions> parseOptions(int argc, char** argv) {
+    CliOptions options;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if ((arg == "-j" || arg == "--jobs") && hasValue) {
+            std::string_view value = argv[++i];
+            if (std::from_chars(value.data(), value.data() + value.size(), options.jobs).ec != std::errc{} ||
+                options.jobs == 0) {
+                return std::nullopt;
+            }
+        } else if ((arg == "-r" || arg == "--root") && hasValue) {
+            options.root = argv[++i];
+        } else if (arg == "--glsl-version" && hasValue) {
+            options.glslVersion = argv[++i];
+        } else if (arg == "--debounce" && hasValue) {
+            std::string_view value = argv[++i];
+            if (std::from_chars(value.data(), value.data() + value.size(), options.debounceMs).ec != std::errc{}) {
+                return std::nullopt;
+            }
+        } else if (arg == "--report") {
+            options.reportLimit = 20;
+            if (hasValue && std::isdigit(static_cast<unsigned char>(argv[i + 1][0]))) {
+                std::string_view value = argv[++i];
+                if (std::from_chars(value.data(), value.data() + value.size(), options.reportLimit).ec !=
+                    std::errc{} || options.reportLimit == 0) {
+                    return std::nullopt;
+                }
+            }
+        } else if (arg == "--depfiles") {
+            options.depfiles = true;
+        } else if (arg == "--watch") {
+            options.watch = true;
+        } else if (arg.starts_with("-") || !options.manifest.empty()) {
+            return std::nullopt;
+        } else {
+            options.manifest = arg;
+        }
+    }
+    if (options.manifest.empty()) {
+        return std::nullopt;
+    }
+    return options;
+}
+
+static std::optional<std::vector<ManifestEntry>> parseManifest(const std::filesystem::path& filepath) {
+    std::ifstream file(filepath);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open manifest: " << filepath.string() << std::endl;
+        return std::nullopt;
+    }
+
+    std::vector<ManifestEntry> entries;
+    // Line numbers of the outputs, since concurrent workers must never write the same file
+    std::unordered_map<std::string, std::size_t> outputs;
+    std::string line;
+    for (std::size_t lineNumber = 1; std::getline(file, line); ++lineNumber) {
+        std::istringstream tokens(line);
+        ManifestEntry entry;
+        std::string output;
+        if (!(tokens >> entry.shader) || entry.shader.starts_with('#')) {
+            continue;
+        }
+        if (!(tokens >> output)) {
+            std::cerr << std::format("{}:{}: Missing output path", filepath.string(), lineNumber) << std::endl;
+            return std::nullopt;
+        }
+        entry.output = output;
+        auto [duplicate, inserted] = outputs.try_emplace(entry.output.lexically_normal().string(), lineNumber);
+        if (!inserted) {
+            std::cerr << std::format("{}:{}: Output is already written by line {}: {}", filepath.string(), lineNumber,
+                duplicate->second, output) << std::endl;
+            return std::nullopt;
+        }
+
+        std::string definition;
+        while (tokens >> definition) {
+            size_t separator = definition.find('=');
+            if (separator == std::string::npos) {
+                entry.definitions.emplace_back(std::move(definition), "");
+            } else {
+                entry.definitions.emplace_back(definition.substr(0, separator), definition.substr(separator + 1));
+            }
+        }
+        entries.push_back(std::move(entry));
+    }
+    return entries;
+}
+
+// Writes the file through a temporary file, unless it already has the given contents. The temporary file is unique to
+// the process and the call, so concurrent writers never share one
+static EntryResult writeIfChanged(const std::filesystem::path& filepath, std::string_view contents) {
+    if (std::optional<std::string> existing = readString(filepath); existing.has_value() && *existing == contents) {
+        return EntryResult::Unchanged;
+    }
+
+    std::error_code ec;
+    if (filepath.has_parent_path()) {
+        std::filesystem::create_directories(filepath.parent_path(), ec);
+    }
+
+    static std::atomic<std::uint64_t> temporaryCount = 0;
+    std::filesystem::path temporary = filepath;
+    temporary += std::format(".{}.{}.tmp", ::getpid(), temporaryCount.fetch_add(1, std::memory_order_relaxed));
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        if (!file.write(contents.data(), static_cast<std::streamsize>(contents.size()))) {
+            std::cerr << "Failed to write: " << temporary.string() << std::endl;
+            file.close();
+            std::filesystem::remove(temporary, ec);
+            return EntryResult::Failed;
+        }
+    }
+    std::filesystem::rename(temporary, filepath, ec);
+    if (ec) {
+        std::filesystem::remove(temporary, ec);
+        std::cerr << "Failed to write: " << filepath.string() << std::endl;
+        return EntryResult::Failed;
+    }
+    return EntryResult::Written;
+}
+
+static std::string escapeMakePath(const std::filesystem::path& filepath) {
+    std::string escaped;
+    for (char c : filepath.generic_string()) {
+        if (c == ' ' || c == '#') {
+            escaped += '\\';
+        } else if (c == '$') {
+            escaped += '$';
+        }
+        escaped += c;
+    }
+    return escaped;
+}
+
+static std::string generateDepfile(const ManifestEntry& entry, const SplitDirectories& paths,
+    const std::vector<std::string>& includedFiles) {
+    std::string depfile = escapeMakePath(entry.output) + ":";
+    depfile += " " + escapeMakePath(paths.getFilepath(SourceType::Source, entry.shader));
+    for (const std::string& include : includedFiles) {
+        depfile += " \\\n  " + escapeMakePath(paths.getFilepath(SourceType::Include, include));
+    }
+    depfile += '\n';
+    return depfile;
+}
+
+static EntryResult writeEntry(const ManifestEntry& entry, const std::optional<std::string>& source,
+    const SplitDirectories& paths, const CliOptions& options, const std::vector<std::string>& includedFiles) {
+    if (!source.has_value()) {
+        std::cerr << "Failed to process: " << entry.shader << std::endl;
+        return EntryResult::Failed;
+    }
+
+    EntryResult result = writeIfChanged(entry.output, *source);
+    if (result != EntryResult::Failed && options.depfiles) {
+        std::filesystem::path depfile = entry.output;
+        depfile += ".d";
+        if (writeIfChanged(depfile, generateDepfile(entry, paths, includedFiles)) == EntryResult::Failed) {
+            return EntryResult::Failed;
+        }
+    }
+    return result;
+}
+
+// Keeps a batch of the shared cache open for its lifetime, even if processing throws
+class BuildBatch {
+public:
+    explicit BuildBatch(const SynchronizedFileProvider<SmartCachedFileProvider>& impl) :
+        impl_(impl) { impl_.withImpl([](const SmartCachedFileProvider& cache) { cache.beginBatch(); }); }
+    ~BuildBatch() { impl_.withImpl([](const SmartCachedFileProvider& cache) { cache.endBatch(); }); }
+
+    BuildBatch(const BuildBatch&) = delete;
+    BuildBatch& operator=(const BuildBatch&) = delete;
+
+private:
+    const SynchronizedFileProvider<SmartCachedFileProvider>& impl_;
+};
+
+struct BuildResult {
+    EntryResult result = EntryResult::Failed;
+    std::vector<std::string> includedFiles;
+};
+
+// Processes the given entries on all workers, every file is validated at most once during the build. If a report is
+// given, the contributions of all headers to the processed entries are added to it
+static void build(const CliSourceProvider& provider, const std::vector<ManifestEntry>& entries,
+    const std::vector<std::size_t>& indices, const CliOptions& options, std::vector<BuildResult>& results,
+    IncludeReport* report = nullptr) {
+    std::vector<BatchJob> jobs;
+    jobs.reserve(indices.size());
+    for (std::size_t index : indices) {
+        jobs.push_back({entries[index].shader, entries[index].definitions});
+    }
+
+    // All workers share one cache. Every output is written by its worker as soon as it is processed, so only one
+    // source per worker is held in memory
+    BatchOptions batchOptions;
+    batchOptions.threadCount = options.jobs;
+    batchOptions.report = report;
+    const SplitDirectories& paths = provider.get().getPathPolicy();
+    {
+        BuildBatch batch(provider.get().getImpl());
+        processBatch(CliProcessor(provider, options.glslVersion), jobs, [&](BatchResult& batchResult) {
+            std::size_t index = indices[batchResult.index];
+            BuildResult& result = results[index];
+            result.includedFiles = std::move(batchResult.includedFiles);
+            result.result = writeEntry(entries[index], batchResult.source, paths, options, result.includedFiles);
+        }, batchOptions);
+    }
+
+    std::size_t written = 0;
+    std::size_t unchanged = 0;
+    std::size_t failed = 0;
+    for (std::size_t index : indices) {
+        written += results[index].result == EntryResult::Written;
+        unchanged += results[index].result == EntryResult::Unchanged;
+        failed += results[index].result == EntryResult::Failed;
+    }
+    std::cout << std::format("{} shaders: {} written, {} unchanged, {} failed", indices.size(), written, unchanged,
+        failed) << std::endl;
+}
+
+static volatile std::sig_atomic_t watching = 1;
+
+static int watch(const CliSourceProvider& provider, const std::vector<ManifestEntry>& entries,
+    const CliOptions& options, std::vector<BuildResult>& results) {
+    std::optional<ShaderWatcher> watcher = ShaderWatcher::create(provider.get().getPathPolicy(),
+        std::chrono::milliseconds(options.debounceMs));
+    if (!watcher.has_value()) {
+        return 1;
+    }
+
+    auto updateGraph = [&](const std::vector<std::size_t>& indices) {
+        // Entries of the same shader differ only in their definitions, which do not affect the included files
+        for (std::size_t index : indices) {
+            watcher->getIncludeGraph().setDependencies(entries[index].shader, results[index].includedFiles);
+        }
+    };
+
+    std::vector<std::size_t> all(entries.size());
+    std::iota(all.begin(), all.end(), 0);
+    updateGraph(all);
+
+    std::signal(SIGINT, [](int) { watching = 0; });
+    std::signal(SIGTERM, [](int) { watching = 0; });
+    std::cout << "Watching for changes..." << std::endl;
+
+    while (watching) {
+        ShaderWatcher::Changes changes = watcher->waitForChanges(std::chrono::milliseconds(200));
+        std::vector<std::string> affected = watcher->getAffectedShaders(changes);
+        if (affected.empty()) {
+            continue;
+        }
+
+        std::vector<std::size_t> indices;
+        for (std::size_t i = 0; i < entries.size(); ++i) {
+            if (std::ranges::binary_search(affected, entries[i].shader)) {
+                indices.push_back(i);
+            }
+        }
+        build(provider, entries, indices, options, results);
+        updateGraph(indices);
+    }
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    std::optional<CliOptions> options = parseOptions(argc, argv);
+    if (!options.has_value()) {
+        printUsage();
+        return 1;
+    }
+
+    std::optional<std::vector<ManifestEntry>> entries = parseManifest(options->manifest);
+    if (!entries.has_value()) {
+        return 1;
+    }
+
+    CliSourceProvider provider(CliFileProvider(SynchronizedFileProvider<SmartCachedFileProvider>{},
+        SplitDirectories(options->root)));
+    std::vector<BuildResult> results(entries->size());
+    std::vector<std::size_t> all(entries->size());
+    std::iota(all.begin(), all.end(), 0);
+
+    if (options->reportLimit > 0) {
+        // The times include the file system accesses, as the cache is still cold during the first build
+        IncludeReport report;
+        build(provider, *entries, all, *options, results, &report);
+        report.write(std::cout, options->reportLimit);
+    } else {
+        build(provider, *entries, all, *options, results);
+    }
+
+    if (options->watch) {
+        return watch(provider, *entries, *options, results);
+    }
+    return std::ranges::any_of(results, [](const BuildResult& result) {
+        return result.result == EntryResult::Failed;
+    }) ? 1 : 0;
+}
@@ -0,0 +1,209 @@
+// MIT License
+//
+// Copyright (c) 2026 Levin Tertilt
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// A daemon that keeps a GLSLSourceProcessor with warm caches resident and serves preprocessing requests from
+// short-lived processes over a Unix domain socket, see glsl/glsl_daemon.h for the protocol and the client
+
+#include <csignal>
+#include <iostream>
+#include <thread>
+
+#include <poll.h>
+#include <sys/stat.h>
+
+#include <glsl/glsl_daemon.h>
+
+// All clients share one cache, which is the only state guarded by a lock
+using DaemonSharedProvider = FileSourceProvider<SynchronizedFileProvider<SmartCachedFileProvider>>;
+using DaemonFileProvider = SharedSourceProvider<DaemonSharedProvider>;
+using DaemonProcessor = GLSLSourceProcessor<DaemonFileProvider>;
+
+static volatile std::sig_atomic_t running = 1;
+
+struct Daemon {
+    DaemonFileProvider provider;
+    std::string glslVersion;
+
+    // Returns the response status and fills the result with the response payload
+    static DaemonStatus handle(DaemonProcessor& processor, const DaemonMessage& request, std::string& result) {
+        DaemonPayloadReader reader(request.payload);
+
+        std::optional<std::string> source;
+        switch (static_cast<DaemonRequest>(request.code)) {
+            case DaemonRequest::GetSource: {
+                std::optional<std::uint8_t> type = reader.readU8();
+                if (!type.has_value() || *type > static_cast<std::uint8_t>(SourceType::Include)) {
+                    return DaemonStatus::BadRequest;
+                }
+                source = processor.getSourceProvider().getSource(static_cast<SourceType>(*type), reader.readRest());
+                break;
+            }
+            case DaemonRequest::Process: {
+                std::optional<std::string_view> name = reader.readString();
+                std::optional<std::uint32_t> count = reader.readU32();
+                if (!name.has_value() || !count.has_value()) {
+                    return DaemonStatus::BadRequest;
+                }
+
+                processor.undefAll();
+                for (std::uint32_t i = 0; i < *count; ++i) {
+                    std::optional<std::string_view> definition = reader.readString();
+                    std::optional<std::string_view> value = reader.readString();
+                    if (!definition.has_value() || !value.has_value()) {
+                        return DaemonStatus::BadRequest;
+                    }
+                    processor.define(std::string(*definition), *value);
+                }
+                source = processor.getShaderSource(std::string(*name));
+                break;
+            }
+            default:
+                return DaemonStatus::BadRequest;
+        }
+
+        if (!source.has_value()) {
+            return DaemonStatus::Failed;
+        }
+        if (source->size() > DAEMON_MAX_PAYLOAD_SIZE) {
+            return DaemonStatus::TooLarge;
+        }
+        result = std::move(*source);
+        return DaemonStatus::Ok;
+    }
+
+    // Whether the client greeted with the magic and the protocol version of this daemon
+    static bool acceptHello(int fd) {
+        std::optional<DaemonMessage> hello = readDaemonMessage(fd);
+        if (!hello.has_value() || hello->code != static_cast<std::uint8_t>(DaemonRequest::Hello)) {
+            return false;
+        }
+        DaemonPayloadReader reader(hello->payload);
+        std::optional<std::uint32_t> magic = reader.readU32();
+        std::optional<std::uint32_t> version = reader.readU32();
+        bool compatible = magic == DAEMON_MAGIC && version == DAEMON_PROTOCOL_VERSION;
+
+        DaemonPayloadWriter writer;
+        writer.writeU32(DAEMON_MAGIC);
+        writer.writeU32(DAEMON_PROTOCOL_VERSION);
+        auto status = compatible ? DaemonStatus::Ok : DaemonStatus::Incompatible;
+        return writeDaemonMessage(fd, static_cast<std::uint8_t>(status), writer.getPayload()) && compatible;
+    }
+
+    // Every client has its own processor, since the definitions are part of the processor state
+    void serve(int fd) {
+        if (!acceptHello(fd)) {
+            ::close(fd);
+            return;
+        }
+
+        DaemonProcessor processor(provider, glslVersion);
+        while (std::optional<DaemonMessage> request = readDaemonMessage(fd)) {
+            std::string result;
+            DaemonStatus status = handle(processor, *request, result);
+            if (!writeDaemonMessage(fd, static_cast<std::uint8_t>(status), result)) {
+                break;
+            }
+        }
+        ::close(fd);
+    }
+};
+
+static int listenOn(const std::string& path) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) {
+        std::cerr << "Socket path is too long: " << path << std::endl;
+        return -1;
+    }
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        std::cerr << "Failed to create socket" << std::endl;
+        return -1;
+    }
+
+    // A leftover socket of a daemon that did not shut down cleanly is replaced, anything else is left alone
+    struct stat status{};
+    if (::lstat(path.c_str(), &status) == 0) {
+        if (!S_ISSOCK(status.st_mode)) {
+            std::cerr << "Refusing to replace something that is not a socket: " << path << std::endl;
+            ::close(fd);
+            return -1;
+        }
+        // Any daemon answering is left running, whatever protocol version it speaks
+        int probe = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        bool answered = probe >= 0 &&
+            ::connect(probe, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0;
+        if (probe >= 0) {
+            ::close(probe);
+        }
+        if (answered) {
+            std::cerr << "Another daemon is already listening on: " << path << std::endl;
+            ::close(fd);
+            return -1;
+        }
+        ::unlink(path.c_str());
+    }
+    if (::bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 || ::listen(fd, 64) != 0) {
+        std::cerr << "Failed to listen on: " << path << std::endl;
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << "Usage: glsl_sp_daemon <socket> <shader root> [glsl version]" << std::endl;
+        return 1;
+    }
+    std::string socketPath = argv[1];
+
+    // Never destroyed, since detached client threads may still use it while the process exits
+    Daemon& daemon = *new Daemon{DaemonFileProvider(DaemonSharedProvider(
+        SynchronizedFileProvider<SmartCachedFileProvider>{}, SplitDirectories(argv[2]))),
+        argc > 3 ? argv[3] : "#version 450 core"};
+
+    int listenFd = listenOn(socketPath);
+    if (listenFd < 0) {
+        return 1;
+    }
+
+    std::signal(SIGINT, [](int) { running = 0; });
+    std::signal(SIGTERM, [](int) { running = 0; });
+    std::signal(SIGPIPE, SIG_IGN);
+
+    while (running) {
+        pollfd descriptor{listenFd, POLLIN, 0};
+        if (::poll(&descriptor, 1, 200) <= 0) {
+            continue;
+        }
+        int clientFd = ::accept(listenFd, nullptr, nullptr);
+        if (clientFd >= 0) {
+            std::thread([&daemon, clientFd] { daemon.serve(clientFd); }).detach();
+        }
+    }
+
+    ::close(listenFd);
+    ::unlink(socketPath.c_str());
+}
@@ -0,0 +1,269 @@
+// MIT License
+//
+// Copyright (c) 2026 Levin Tertilt
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Generates random shader corpora and checks that GLSLSourceProcessor produces byte identical outputs and the same
+// included files as the naive ReferenceProcessor, with sources from memory and from disk through every file provider,
+// and with includes read ahead on a thread pool. FlatHashMap is checked against std::map with random insertions and
+// erasures, including copies taken after erasing.
+// Every iteration uses the seed plus its index, so a failing iteration can be reproduced with --seed and
+// --iterations 1
+
+#include <charconv>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <string_view>
+#include <vector>
+
+#include <glsl/glsl_compressed_file_provider.h>
+
+#include "reference_processor.h"
+
+struct Corpus {
+    std::vector<std::pair<std::string, std::string>> sources;
+    std::vector<std::pair<std::string, std::string>> includes;
+    std::vector<std::pair<std::string, std::string>> definitions;
+};
+
+static std::string generateFile(std::mt19937& random, std::size_t includeCount) {
+    constexpr std::string_view CODE[] = {
+        "vec4 color = texture(u_Texture, fIn.texCoords);",
+        "#ifdef USE_ALPHA_CUTOUT",
+        "#endif",
+        "uniform sampler2D u_Texture; // \"quoted\"",
+        "",
+        "    out_Color = color;\r",
+        "#version 330 core",
+        "#define INCLUDE_GUARD",
+    };
+
+    auto choose = [&](std::size_t count) { return std::uniform_int_distribution<std::size_t>(0, count - 1)(random); };
+    // Mostly existing includes, but sometimes one that is missing
+    auto includeName = [&] {
+        std::size_t index = choose(includeCount + 1);
+        return index % 4 == 3 ? std::format("dir/include_{}.glsl", index) : std::format("include_{}.glsl", index);
+    };
+
+    std::string file;
+    std::size_t lineCount = choose(12);
+    for (std::size_t i = 0; i < lineCount; ++i) {
+        switch (choose(20)) {
+            case 0: file += std::format("  #include \"{}\"", includeName()); break;
+            case 1: file += std::format("#include \"{}\" // comment", includeName()); break;
+            case 2: file += std::format("#include \"{}\"\r", includeName()); break;
+            case 3: file += std::format("#include{}\"{}\"", choose(2) == 0 ? "" : "  ", includeName()); break;
+            // Invalid directives
+            case 4: file += choose(4) == 0 ? "#include <missing.glsl>" : "#include \"include_0.glsl"; break;
+            case 5:
+            case 6:
+            case 7:
+            case 8: file += std::format("#include \"{}\"", includeName()); break;
+            default: file += CODE[choose(std::size(CODE))]; break;
+        }
+        if (i + 1 < lineCount || choose(4) != 0) {
+            file += '\n';
+        }
+    }
+    return file;
+}
+
+static Corpus generateCorpus(std::uint32_t seed) {
+    std::mt19937 random(seed);
+    auto choose = [&](std::size_t count) { return std::uniform_int_distribution<std::size_t>(0, count - 1)(random); };
+
+    Corpus corpus;
+    std::size_t includeCount = 1 + choose(12);
+    for (std::size_t i = 0; i < includeCount; ++i) {
+        std::string name = i % 4 == 3 ? std::format("dir/include_{}.glsl", i) : std::format("include_{}.glsl", i);
+        corpus.includes.emplace_back(std::move(name), generateFile(random, includeCount));
+    }
+    for (std::size_t i = 0, count = 1 + choose(4); i < count; ++i) {
+        corpus.sources.emplace_back(std::format("shader_{}.glsl", i), generateFile(random, includeCount));
+    }
+    for (std::size_t i = 0, count = choose(4); i < count; ++i) {
+        corpus.definitions.emplace_back(std::format("DEFINITION_{}", i), choose(2) == 0 ? "" : std::to_string(i));
+    }
+    return corpus;
+}
+
+static void writeCorpus(const Corpus& corpus, const std::filesystem::path& root) {
+    std::filesystem::remove_all(root);
+    auto write = [](const std::filesystem::path& filepath, std::string_view content) {
+        std::filesystem::create_directories(filepath.parent_path());
+        std::ofstream file(filepath, std::ios::binary);
+        file.write(content.data(), static_cast<std::streamsize>(content.size()));
+    };
+    for (const auto& [name, source] : corpus.sources) {
+        write(root / "src" / name, source);
+    }
+    for (const auto& [name, source] : corpus.includes) {
+        write(root / "include" / name, source);
+    }
+}
+
+// Runs every shader twice through the processor, so that the second run is served from the caches
+// The number of shaders that were processed successfully, to make sure that the corpora do not mostly fail
+static std::uint64_t successfulShaders = 0;
+
+template<SourceProvider PROVIDER>
+static bool compare(std::string_view variant, std::uint32_t seed, const Corpus& corpus, PROVIDER provider,
+    const MemorySourceProvider& memory, std::shared_ptr<ThreadPool> pool = nullptr) {
+    GLSLSourceProcessor<PROVIDER> processor(std::move(provider), "#version 450 core", DISABLED_LOGGING);
+    processor.setThreadPool(std::move(pool));
+    for (const auto& [name, value] : corpus.definitions) {
+        processor.define(std::string(name), value);
+    }
+    std::vector<std::pair<std::string, std::string>> definitions(processor.getDefinitions().begin(),
+        processor.getDefinitions().end());
+    ReferenceProcessor reference(memory, "#version 450 core", std::move(definitions));
+
+    for (int run = 0; run < 2; ++run) {
+        for (const auto& [name, _] : corpus.sources) {
+            std::vector<std::string> expectedFiles;
+            std::vector<std::string> actualFiles;
+            std::optional<std::string> expected = reference.getShaderSource(name, expectedFiles);
+            std::optional<std::string> actual = processor.getShaderSource(name, actualFiles);
+
+            if (expected.has_value() != actual.has_value()) {
+                std::cout << std::format("seed {}, {}, {}: the reference {}, but the processor {}\n", seed, variant,
+                    name, expected ? "succeeds" : "fails", actual ? "succeeds" : "fails");
+                return false;
+            }
+            if (expected.has_value() && *expected != *actual) {
+                auto [position, _] = std::ranges::mismatch(*expected, *actual);
+                std::cout << std::format("seed {}, {}, {}: outputs differ at byte {}\n--- reference\n{}\n--- "
+                    "processor\n{}\n", seed, variant, name, position - expected->begin(), *expected, *actual);
+                return false;
+            }
+            if (expected.has_value() && expectedFiles != actualFiles) {
+                std::cout << std::format("seed {}, {}, {}: included files differ\n", seed, variant, name);
+                return false;
+            }
+            successfulShaders += expected.has_value();
+        }
+    }
+    return true;
+}
+
+// Inserts and erases random keys in a StringMap and a std::map, and checks the map and copies of it after every step
+static bool compareFlatMap(std::uint32_t seed) {
+    std::mt19937 random(seed);
+    StringMap<std::uint32_t> map;
+    std::map<std::string, std::uint32_t> reference;
+    auto matches = [&reference](const StringMap<std::uint32_t>& actual) {
+        if (actual.size() != reference.size()) {
+            return false;
+        }
+        for (const auto& [key, value] : reference) {
+            auto it = actual.find(key);
+            if (it == actual.end() || it->second != value) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    for (int step = 0; step < 400; ++step) {
+        std::string key = std::format("key{}", random() % 64);
+        if (random() % 3 == 0) {
+            map.erase(key);
+            reference.erase(key);
+        } else {
+            std::uint32_t value = random();
+            map.insert_or_assign(key, value);
+            reference.insert_or_assign(key, value);
+        }
+
+        StringMap<std::uint32_t> copy(map);
+        StringMap<std::uint32_t> assigned;
+        assigned = map;
+        if (!matches(map) || !matches(copy) || !matches(assigned)) {
+            std::cout << std::format("seed {}, FlatHashMap: differs from std::map after step {}\n", seed, step);
+            return false;
+        }
+    }
+    return true;
+}
+
+static void printUsage() {
+    std::cerr << "Usage: glsl_sp_difftest [--seed <seed>] [--iterations <count>]\n";
+}
+
+int main(int argc, char** argv) {
+    std::uint32_t seed = 1;
+    std::uint32_t iterations = 1000;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        std::uint32_t* target = arg == "--seed" ? &seed : arg == "--iterations" ? &iterations : nullptr;
+        if (target == nullptr || i + 1 >= argc) {
+            printUsage();
+            return 2;
+        }
+        std::string_view value = argv[++i];
+        if (std::from_chars(value.data(), value.data() + value.size(), *target).ec != std::errc{}) {
+            printUsage();
+            return 2;
+        }
+    }
+
+    std::filesystem::path root = std::filesystem::temp_directory_path() / "glsl_sp_difftest";
+    auto pool = std::make_shared<ThreadPool>(4);
+    bool success = true;
+    for (std::uint32_t i = 0; i < iterations && success; ++i) {
+        Corpus corpus = generateCorpus(seed + i);
+        MemorySourceProvider memory;
+        for (const auto& [name, source] : corpus.sources) {
+            memory.addSource(SourceType::Source, name, source);
+        }
+        for (const auto& [name, source] : corpus.includes) {
+            memory.addSource(SourceType::Include, name, source);
+        }
+        writeCorpus(corpus, root);
+
+        SplitDirectories paths(root);
+        success = compareFlatMap(seed + i) && compare("memory", seed + i, corpus, memory, memory) &&
+            compare("SillyFileProvider", seed + i, corpus,
+                FileSourceProvider(SillyFileProvider{}, paths, DISABLED_LOGGING), memory) &&
+            compare("CachedFileProvider", seed + i, corpus,
+                FileSourceProvider(CachedFileProvider{}, paths, DISABLED_LOGGING), memory) &&
+            compare("CompressedCachedFileProvider", seed + i, corpus,
+                FileSourceProvider(CompressedCachedFileProvider(2), paths, DISABLED_LOGGING), memory) &&
+            compare("SmartCachedFileProvider", seed + i, corpus,
+                FileSourceProvider(SmartCachedFileProvider{}, paths, DISABLED_LOGGING), memory) &&
+            compare("memory, prefetched", seed + i, corpus, memory, memory, pool) &&
+            compare("SynchronizedFileProvider, prefetched", seed + i, corpus,
+                FileSourceProvider(SynchronizedFileProvider<CachedFileProvider>{}, paths, DISABLED_LOGGING), memory,
+                pool);
+    }
+
+    std::error_code ec;
+    std::filesystem::remove_all(root, ec);
+    if (success) {
+        std::cout << std::format("{} corpora processed identically, {} shaders succeeded\n", iterations,
+            successfulShaders);
+    }
+    return success ? 0 : 1;
+}
@@ -0,0 +1,135 @@
+// MIT License
+//
+// Copyright (c) 2026 Levin Tertilt
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <glsl/glsl_source_processor.h>
+
+/// A deliberately naive implementation of the semantics of GLSLSourceProcessor, used as the reference when testing
+/// its optimized paths. It must stay simple enough to be obviously correct, performance does not matter:
+///
+/// - The output of a shader starts with the version line, followed by a define directive for every definition in the
+///   order of GLSLSourceProcessor::getDefinitions
+/// - The source is split at every '\n', every resulting line, including the last one, is followed by a '\n'. An empty
+///   source has no lines
+/// - A line starting with #include is replaced by the processed include named between its first and last quotation
+///   mark. Includes already expanded for the shader are replaced by nothing
+/// - Invalid include directives, missing files and includes that include themselves, directly or through other
+///   includes, fail the whole shader
+/// - Includes nested deeper than GLSLSourceProcessor::DEFAULT_MAX_INCLUDE_DEPTH fail the whole shader
+template<SourceProvider SOURCE_PROVIDER>
+class ReferenceProcessor {
+public:
+    ReferenceProcessor(const SOURCE_PROVIDER& sourceProvider, std::string glslVersion,
+        std::vector<std::pair<std::string, std::string>> definitions) :
+        sourceProvider_(sourceProvider),
+        glslVersion_(std::move(glslVersion)),
+        definitions_(std::move(definitions)) {}
+
+    std::optional<std::string> getShaderSource(const std::string& name,
+        std::vector<std::string>& includedFiles) const {
+        includedFiles.clear();
+        std::optional<std::string> source = sourceProvider_.getSource(SourceType::Source, name);
+        if (!source.has_value()) {
+            return std::nullopt;
+        }
+
+        std::string result = glslVersion_ + "\n";
+        for (const auto& [definition, value] : definitions_) {
+            result += "#define " + definition + " " + value + "\n";
+        }
+        std::vector<std::string> activeIncludes;
+        if (!appendProcessed(*source, includedFiles, activeIncludes, result)) {
+            return std::nullopt;
+        }
+        return result;
+    }
+
+private:
+    bool appendProcessed(const std::string& source, std::vector<std::string>& includedFiles,
+        std::vector<std::string>& activeIncludes, std::string& result) const {
+        for (const std::string& line : splitLines(source)) {
+            if (line.substr(0, 8) != "#include") {
+                result += line + "\n";
+                continue;
+            }
+
+            std::size_t first = line.find('"');
+            std::size_t last = line.rfind('"');
+            if (first == std::string::npos || last == first) {
+                return false;
+            }
+
+            std::string name = line.substr(first + 1, last - first - 1);
+            for (const std::string& active : activeIncludes) {
+                if (active == name) {
+                    return false;
+                }
+            }
+
+            bool alreadyIncluded = false;
+            for (const std::string& included : includedFiles) {
+                alreadyIncluded = alreadyIncluded || included == name;
+            }
+            if (alreadyIncluded) {
+                continue;
+            }
+            includedFiles.push_back(name);
+            if (activeIncludes.size() == GLSLSourceProcessor<SOURCE_PROVIDER>::DEFAULT_MAX_INCLUDE_DEPTH) {
+                return false;
+            }
+
+            activeIncludes.push_back(name);
+            std::optional<std::string> include = sourceProvider_.getSource(SourceType::Include, name);
+            if (!include.has_value() || !appendProcessed(*include, includedFiles, activeIncludes, result)) {
+                return false;
+            }
+            activeIncludes.pop_back();
+        }
+        return true;
+    }
+
+    static std::vector<std::string> splitLines(const std::string& source) {
+        if (source.empty()) {
+            return {};
+        }
+        std::vector<std::string> lines(1);
+        for (char c : source) {
+            if (c == '\n') {
+                lines.emplace_back();
+            } else {
+                lines.back() += c;
+            }
+        }
+        return lines;
+    }
+
+    const SOURCE_PROVIDER& sourceProvider_;
+    std::string glslVersion_;
+    std::vector<std::pair<std::string, std::string>> definitions_;
+};